@@ -22,19 +22,78 @@
 
 #include <QEventLoop>
 #include <QDebug>
+#include <QtConcurrent>
+
+#include <signal.h>
+#include <unistd.h>
 
 #include "cmd.h"
+#include "cmdrecorder.h"
+
+// pid followed by all its descendants, read from /proc/<pid>/task/<pid>/children
+static QList<qint64> processTree(qint64 pid)
+{
+    QList<qint64> pids;
+    if (pid <= 0) {
+        return pids;
+    }
+    pids << pid;
+    for (int i = 0; i < pids.size(); ++i) {
+        const QString id = QString::number(pids.at(i));
+        QFile file("/proc/" + id + "/task/" + id + "/children");
+        if (!file.open(QFile::ReadOnly)) {
+            continue;
+        }
+        for (const QByteArray &child : file.readAll().split(' ')) {
+            bool ok;
+            qint64 child_pid = child.trimmed().toLongLong(&ok);
+            if (ok) pids << child_pid;
+        }
+    }
+    return pids;
+}
+
+// user + system cpu ticks of a process, fields 14 and 15 of /proc/<pid>/stat
+static qint64 cpuTime(qint64 pid)
+{
+    QFile file("/proc/" + QString::number(pid) + "/stat");
+    if (!file.open(QFile::ReadOnly)) {
+        return 0;
+    }
+    const QByteArray stat = file.readAll();
+    const QList<QByteArray> fields = stat.mid(stat.lastIndexOf(')') + 2).split(' '); // comm can contain spaces
+    return fields.value(11).toLongLong() + fields.value(12).toLongLong();
+}
+
+// cpu ticks used by all the processes in the list
+static qint64 treeCpuTime(const QList<qint64> &pids)
+{
+    qint64 cpu = 0;
+    for (qint64 pid : pids) {
+        cpu += cpuTime(pid);
+    }
+    return cpu;
+}
+
+// resident memory of a process in bytes, second field of /proc/<pid>/statm
+static qint64 residentMemory(qint64 pid)
+{
+    static const qint64 page_size = sysconf(_SC_PAGESIZE);
+    QFile file("/proc/" + QString::number(pid) + "/statm");
+    if (!file.open(QFile::ReadOnly)) {
+        return 0;
+    }
+    return file.readLine().split(' ').value(1).toLongLong() * page_size;
+}
 
 Cmd::Cmd(QObject *parent) :
-    QObject(parent), buffer_out(&out), buffer_err(&err)
+    QObject(parent), buffer_out(&out), buffer_err(&err), out_sha256(QCryptographicHash::Sha256)
 {
-    proc = new QProcess(this);
+    proc = nullptr;
     timer = new QTimer(this);
 
     connect(timer, &QTimer::timeout, this, &Cmd::tick);
-    connect(proc, static_cast<void (QProcess::*)(int)>(&QProcess::finished), timer, &QTimer::stop);
-    connect(proc, &QProcess::readyReadStandardOutput, this, &Cmd::onStdoutAvailable);
-    connect(proc, &QProcess::readyReadStandardError, this, &Cmd::onStderrAvailable);
+    setBackend(new CmdProcessBackend(this));
 }
 
 Cmd::~Cmd()
@@ -49,40 +108,70 @@ Cmd::~Cmd()
 
 // this function is running the command, takes cmd_str and optional estimated completion time
 int Cmd::run(const QString &cmd_str, const QStringList &options, int est_duration)
+{
+    return runAttempts(cmd_str, QStringList(), options, est_duration);
+}
+
+// run a program directly with its arguments, without going through bash
+int Cmd::exec(const QStringList &argv, const QStringList &options, int est_duration)
+{
+    if (argv.isEmpty()) {
+        return -1;
+    }
+    return runAttempts(argv.join(' '), argv, options, est_duration);
+}
+
+// run() and exec() with the retry policy applied
+int Cmd::runAttempts(const QString &cmd_str, const QStringList &argv, const QStringList &options, int est_duration)
 {
     if (this->isRunning()) { // allow only one process at a time
         if(debug >= 1) qDebug() << "process already running";
         return -1;
     }
+    int exit_code = runOnce(cmd_str, argv, options, est_duration);
+    for (int attempt = 1; shouldRetry(attempt, exit_code); ++attempt) {
+        const int delay = retry_policy.delay(attempt);
+        if (debug >= 1) qDebug() << "exit code" << exit_code << "retrying in" << delay << "ms, attempt" << attempt + 1;
+        QEventLoop loop;
+        QTimer::singleShot(delay, &loop, &QEventLoop::quit);
+        retry_wait = &loop;
+        loop.exec();
+        retry_wait = nullptr;
+        if (stop_reason == Canceled) { // terminate() or kill() during the wait
+            break;
+        }
+        exit_code = runOnce(cmd_str, argv, options, est_duration);
+    }
+    if (compress_output) compressOutput();
+    return exit_code;
+}
 
-    // reset variables if function is reused
-    this->est_duration = est_duration;
-    this->elapsed_time = 0;  // reset time counter
-    this->out.clear();
-    this->err.clear();
-
-    proc->start("/bin/bash", QStringList() << "-c" << cmd_str);
-
-    // start timer when started
-    proc->waitForStarted();
-    emit started();
+// the output is only rebuilt when the policy has a pattern to match it against
+bool Cmd::shouldRetry(int attempt, int exit_code) const
+{
+    if (stop_reason != NotStopped || !retry_policy.mayRetry(attempt, exit_code)) {
+        return false;
+    }
+    if (retry_policy.pattern.pattern().isEmpty()) {
+        return true;
+    }
+    return retry_policy.shouldRetry(attempt, exit_code, capturedOutput(), capturedError());
+}
 
-    if (options.contains("slowtick")) {
-        timer->start(1000);
-    } else {
-        timer->start(100);
+// one attempt of run(), emits finished() for each attempt
+int Cmd::runOnce(const QString &cmd_str, const QStringList &argv, const QStringList &options, int est_duration)
+{
+    if (!startProcess(cmd_str, argv, options, est_duration)) {
+        return -1;
     }
 
     QEventLoop loop;
-    connect(proc, static_cast<void (QProcess::*)(int)>(&QProcess::finished), &loop, &QEventLoop::quit);
-
-    bool quiet = true;
-    if (debug == 2) quiet = options.contains("quiet");
-    else if (debug > 2) quiet = false;
+    connect(proc, &CmdBackend::finished, &loop, &QEventLoop::quit);
 
-    if (!quiet) qDebug() << proc->arguments().at(1);
-
-    loop.exec();
+    in_run = true; // kills from watchdogs or slots leave the finished() signal to us
+    if (this->isRunning()) { // could have failed to start or finished already
+        loop.exec();
+    }
 
     // kill process if still running after loop finished
     if (this->isRunning()) {
@@ -90,34 +179,70 @@ int Cmd::run(const QString &cmd_str, const QStringList &options, int est_duratio
             this->kill();
         }
     }
+    in_run = false;
+
+    // a command that never started is a failure whatever the backend reports
+    const int exit_code = start_failed ? -1 : proc->exitCode();
+    const QProcess::ExitStatus exit_status = start_failed ? QProcess::CrashExit : proc->exitStatus();
+    flushLineFilter();
+    if (recorder) recorder->endRun(exit_code, exit_status);
+    emit finished(exit_code, exit_status);
+    return getExitCode(isQuiet(options));
+}
 
-    emit finished(proc->exitCode(), proc->exitStatus());
-    return getExitCode(quiet);
+// start the command without blocking, finished() is emitted when the process ends
+bool Cmd::start(const QString &cmd_str, const QStringList &options, int est_duration)
+{
+    if (!startProcess(cmd_str, QStringList(), options, est_duration)) {
+        return false;
+    }
+    async = true;
+    if (start_failed) { // report it like a finished run
+        QTimer::singleShot(0, this, [this]() { onFinished(-1, QProcess::CrashExit); });
+    } else if (!this->isRunning()) { // finished already
+        QTimer::singleShot(0, this, [this]() { onFinished(proc->exitCode(), proc->exitStatus()); });
+    }
+    return true;
 }
 
 // kill process, return true for success
 bool Cmd::kill()
 {
     if (!this->isRunning()) {
+        cancelRetry();
         return true; // returns true because process is not running
     }
+    if (stop_reason == NotStopped) stop_reason = Canceled; // no retry after a cancelled run
     if (debug >= 1) qDebug() << "killing parent process:" << proc->processId();
+    const bool reported = async || in_run; // start() reports in onFinished(), run() after its loop
     proc->kill();
     proc->waitForFinished(1000);
-    emit finished(proc->exitCode(), proc->exitStatus());
+    if (!reported) emit finished(proc->exitCode(), proc->exitStatus());
     return (!this->isRunning());
 }
 
+// stop a run() waiting to retry, the next attempt is not started
+void Cmd::cancelRetry()
+{
+    if (retry_wait) {
+        stop_reason = Canceled;
+        retry_wait->quit();
+    }
+}
+
 // terminate process, return true for success
 bool Cmd::terminate()
 {
     if (!this->isRunning()) {
+        cancelRetry();
         return true; // returns true because process is not running
     }
+    if (stop_reason == NotStopped) stop_reason = Canceled; // no retry after a cancelled run
     if (debug >= 1) qDebug() << "terminating parent process:" << proc->processId();
+    const bool reported = async || in_run;
     proc->terminate();
     proc->waitForFinished(1000);
-    emit finished(proc->exitCode(), proc->exitStatus());
+    if (!reported) emit finished(proc->exitCode(), proc->exitStatus());
     return (!this->isRunning());
 }
 
@@ -159,61 +284,134 @@ bool Cmd::pause()
         if (debug >= 1) qDebug() << "process not running";
         return false;
     }
-    QString id =  QString::number(proc->processId());
-    if (debug >= 1) qDebug() << "pausing process: " << id;
+    if (debug >= 1) qDebug() << "pausing process: " << proc->processId();
     timer->stop();
-    return (system("kill -STOP " + id.toUtf8()) == 0);
+    return proc->pause();
 }
 
 // resume process
 bool Cmd::resume()
 {
-    QString id =  QString::number(proc->processId());
-    if (id == "0") {
-        if (debug >= 1) qDebug() << "process id not found";
+    if (!this->isRunning()) {
+        if (debug >= 1) qDebug() << "process not running";
         return false;
     }
-    if (debug >= 1) qDebug() << "resuming process:" << id;
+    if (debug >= 1) qDebug() << "resuming process:" << proc->processId();
+    last_activity.start(); // time spent paused is not a stall
     timer->start();
-    return (system("kill -CONT " + id.toUtf8()) == 0);
+    return proc->resume();
 }
 
 // get the output of the command
 QString Cmd::getOutput() const
 {
-    return out.trimmed();
+    return capturedOutput().trimmed();
 }
 
 // runs the command passed as argument and return output
 QString Cmd::getOutput(const QString &cmd_str,  const QStringList &options, int est_duration)
 {
     this->run(cmd_str, options, est_duration);
-    return out.trimmed();
+    return capturedOutput().trimmed();
 }
 
 // on std out available emit the output
 void Cmd::onStdoutAvailable()
 {
-    line_out = proc->readAllStandardOutput();
+    const QByteArray data = proc->readAllStandardOutput();
+    last_activity.start();
+    stall_reported = false;
+    if (recorder) recorder->addOutput(data);
+    if (hash_out) out_hash.addData(data.constData(), data.size());
+    if (sha256_out) out_sha256.addData(data);
+    line_out = data;
+    const QString kept = line_filter.isEmpty() ? line_out : line_filter.filter(line_out, &filter_out);
+    if (line_filter.drop_rejected) line_out = kept;
     if (line_out != "") {
         emit outputAvailable(line_out);
     }
-    buffer_out << line_out;
+    storeOutput(kept);
 }
 
 void Cmd::onStderrAvailable()
 {
-    line_err = proc->readAllStandardError();
+    const QByteArray data = proc->readAllStandardError();
+    last_activity.start();
+    stall_reported = false;
+    if (recorder) recorder->addError(data);
+    line_err = data;
+    const QString kept = line_filter.isEmpty() ? line_err : line_filter.filter(line_err, &filter_err);
+    if (line_filter.drop_rejected) line_err = kept;
     if (line_err != "") {
         emit errorAvailable(line_err);
     }
-    buffer_err << line_err;
+    storeError(kept);
+}
+
+// the unterminated last lines held back by the line filter
+void Cmd::flushLineFilter()
+{
+    if (line_filter.isEmpty()) {
+        return;
+    }
+    line_out = line_filter.flush(&filter_out);
+    if (line_out != "") {
+        if (line_filter.drop_rejected) emit outputAvailable(line_out);
+        storeOutput(line_out);
+    }
+    line_err = line_filter.flush(&filter_err);
+    if (line_err != "") {
+        if (line_filter.drop_rejected) emit errorAvailable(line_err);
+        storeError(line_err);
+    }
+}
+
+void Cmd::storeError(const QString &text)
+{
+    if (discard) {
+        return;
+    }
+    if (dedup) {
+        dedup_err.append(text);
+    } else {
+        buffer_err << text;
+    }
+}
+
+void Cmd::storeOutput(const QString &text)
+{
+    if (discard) {
+        return;
+    }
+    if (dedup) {
+        dedup_out.append(text);
+    } else {
+        buffer_out << text;
+        out_index.append(text);
+    }
+    if (search_out) out_search.append(text);
+}
+
+// report the end of a run started with start()
+void Cmd::onFinished(int exit_code, QProcess::ExitStatus exit_status)
+{
+    proc_finished = true;
+    if (!async) { // run() reports after its event loop returns
+        return;
+    }
+    async = false;
+    flushLineFilter();
+    if (recorder) recorder->endRun(exit_code, exit_status);
+    emit finished(exit_code, exit_status);
+    if (compress_output) compressOutput();
 }
 
 // slot called by timer that emits a counter and the estimated duration to be used by progress bar
 void Cmd::tick()
 {
     emit runTime(++elapsed_time, est_duration);
+    if (memory_budget > 0) checkMemory();
+    if (stall_timeout > 0 && this->isRunning()) checkStall();
 }
 
 // check if process is starting or running
@@ -222,6 +420,30 @@ bool Cmd::isRunning() const
     return (proc->state() != QProcess::NotRunning) ? true : false;
 }
 
+// replace the process backend, e.g. with CmdMockBackend for load testing
+bool Cmd::setBackend(CmdBackend *backend)
+{
+    if (!backend || backend == proc) {
+        return false;
+    }
+    if (proc) {
+        if (this->isRunning()) {
+            if (debug >= 1) qDebug() << "cannot change backend while process is running";
+            delete backend; // owned either way, don't leak it
+            return false;
+        }
+        delete proc;
+    }
+    proc = backend;
+    proc->setParent(this);
+
+    connect(proc, &CmdBackend::finished, timer, &QTimer::stop);
+    connect(proc, &CmdBackend::readyReadStandardOutput, this, &Cmd::onStdoutAvailable);
+    connect(proc, &CmdBackend::readyReadStandardError, this, &Cmd::onStderrAvailable);
+    connect(proc, &CmdBackend::finished, this, &Cmd::onFinished);
+    return true;
+}
+
 // set a Fifo file to be used for interprocess communication
 bool Cmd::connectFifo(const QString &file_name)
 {
@@ -247,9 +469,206 @@ void Cmd::disconnectFifo()
     }
 }
 
+// record the following runs, see CmdRecorder and CmdReplayBackend
+void Cmd::setRecorder(CmdRecorder *recorder)
+{
+    this->recorder = recorder;
+}
+
+// pin the following runs to the given cpus
+void Cmd::setCpuAffinity(const QList<int> &cpus)
+{
+    limits.cpus = cpus;
+}
+
+// keep only matching lines of the following runs, see CmdLineFilter
+void Cmd::setLineFilter(const CmdLineFilter &filter)
+{
+    line_filter = filter;
+}
+
+CmdLineFilter Cmd::getLineFilter() const
+{
+    return line_filter;
+}
+
+// rlimits, nice, I/O priority and cpu set are set between fork and exec, no
+// nice/ionice/taskset wrappers are spawned
+void Cmd::setLimits(const CmdLimits &limits)
+{
+    this->limits = limits;
+}
+
+CmdLimits Cmd::getLimits() const
+{
+    return limits;
+}
+
+// sampled on every tick, the child is usually bash so its descendants are counted too
+void Cmd::setMemoryBudget(qint64 bytes)
+{
+    memory_budget = qMax(qint64(0), bytes);
+}
+
+qint64 Cmd::getMemoryBudget() const
+{
+    return memory_budget;
+}
+
+// failed runs matching the policy are run again after a backoff delay
+void Cmd::setRetryPolicy(const CmdRetryPolicy &policy)
+{
+    retry_policy = policy;
+}
+
+CmdRetryPolicy Cmd::getRetryPolicy() const
+{
+    return retry_policy;
+}
+
+void Cmd::setStallTimeout(int secs, bool terminate, bool check_cpu)
+{
+    stall_timeout = qMax(0, secs);
+    stall_terminate = terminate;
+    stall_check_cpu = check_cpu;
+}
+
+int Cmd::getStallTimeout() const
+{
+    return stall_timeout;
+}
+
+Cmd::StopReason Cmd::getStopReason() const
+{
+    return stop_reason;
+}
+
+// kill the whole process tree when its resident memory goes over budget
+void Cmd::checkMemory()
+{
+    const QList<qint64> pids = processTree(proc->processId());
+    qint64 rss = 0;
+    for (qint64 pid : pids) {
+        rss += residentMemory(pid);
+    }
+    if (rss <= memory_budget) {
+        return;
+    }
+    if (debug >= 1) qDebug() << "memory budget exceeded:" << rss << "bytes, killing process tree";
+    stop_reason = MemoryLimit;
+    killTree(pids);
+}
+
+// no output for stall_timeout seconds; with stall_check_cpu a tree still using cpu is busy, not stuck
+void Cmd::checkStall()
+{
+    if (stall_reported || !last_activity.hasExpired(stall_timeout * 1000LL)) {
+        return;
+    }
+    const QList<qint64> pids = processTree(proc->processId());
+    if (stall_check_cpu) {
+        const qint64 cpu = treeCpuTime(pids);
+        if (cpu != stall_cpu) {
+            stall_cpu = cpu;
+            last_activity.start();
+            return;
+        }
+    }
+    if (debug >= 1) qDebug() << "process stalled for" << stall_timeout << "seconds:" << proc->processId();
+    stall_reported = true;
+    emit stalled();
+    if (stall_terminate && this->isRunning()) {
+        stop_reason = Stalled;
+        killTree(pids);
+    }
+}
+
+// kill descendants first so nothing gets reparented, then the child itself
+void Cmd::killTree(const QList<qint64> &pids)
+{
+    for (int i = pids.size() - 1; i > 0; --i) {
+        ::kill(pids.at(i), SIGKILL);
+    }
+    this->kill();
+}
+
+// hashed on the fly in onStdoutAvailable, no second pass over the output
+quint64 Cmd::getOutputHash() const
+{
+    return hash_out ? out_hash.result() : 0;
+}
+
+QByteArray Cmd::getOutputSha256() const
+{
+    return sha256_out ? out_sha256.result() : QByteArray();
+}
+
+// captured output with runs of identical lines folded, needs the "dedup" option
+QString Cmd::getCompactOutput() const
+{
+    if (!dedup) {
+        return getOutput();
+    }
+    if (compressed) { // dedup_out was dropped, fold the unpacked text again
+        CmdDedupBuffer folded(0);
+        folded.append(capturedOutput());
+        return folded.toCompactString().trimmed();
+    }
+    return dedup_out.toCompactString().trimmed();
+}
+
+// number of captured stdout lines, getLine() and getLines() look them up in the store
+// that holds the output (line index, dedup runs or packed blocks) instead of splitting it
+int Cmd::getLineCount() const
+{
+    if (compressed) return packedOutput().lineCount();
+    return dedup ? dedup_out.lineCount() : out_index.lineCount();
+}
+
+QString Cmd::getLine(int n) const
+{
+    if (compressed) return packedOutput().line(n);
+    return dedup ? dedup_out.line(n) : out_index.line(out, n);
+}
+
+QStringList Cmd::getLines(int first, int count) const
+{
+    QStringList lines;
+    const int last = qMin(first + count, getLineCount());
+    for (int n = qMax(0, first); n < last; ++n) {
+        lines << getLine(n);
+    }
+    return lines;
+}
+
+// stdout lines containing the needle, narrowed through the trigram index when the
+// run used the "search" option; only the candidate lines are looked up
+QVector<int> Cmd::findLines(const QString &needle, Qt::CaseSensitivity cs) const
+{
+    QVector<int> lines;
+    if (search_out) {
+        lines = out_search.candidates(needle);
+    } else {
+        const int count = getLineCount();
+        lines.reserve(count);
+        for (int n = 0; n < count; ++n) {
+            lines.append(n);
+        }
+    }
+    const bool plain = !compressed && !dedup; // match in place, no copy of the line
+    QVector<int> found;
+    for (int n : lines) {
+        if (plain ? out.midRef(out_index.lineStart(n), out_index.lineLength(n)).contains(needle, cs)
+                  : getLine(n).contains(needle, cs)) {
+            found.append(n);
+        }
+    }
+    return found;
+}
+
 QString Cmd::getError() const
 {
-    return err.trimmed();
+    return capturedError().trimmed();
 }
 
 // get the exit code of the finished process
@@ -257,6 +676,10 @@ int Cmd::getExitCode(bool quiet) const
 {
     if (debug < 2) quiet = true;
     else if (debug > 2) quiet = false;
+    if (start_failed) {
+        if (!quiet) qDebug() << "failed to start";
+        return -1;
+    }
     if (proc->exitStatus() != 0) { // check first if process crashed, it might still return exit code = 0
         if (!quiet) qDebug() << "exit status:" << proc->exitStatus();
         return proc->exitStatus();
@@ -266,6 +689,142 @@ int Cmd::getExitCode(bool quiet) const
     }
 }
 
+// output of the last run, unpacked again if it was compressed or deduplicated
+QString Cmd::capturedOutput() const
+{
+    if (compressed) return packedOutput().unpack();
+    return dedup ? dedup_out.toString() : out;
+}
+
+QString Cmd::capturedError() const
+{
+    if (compressed) return packedError().unpack();
+    return dedup ? dedup_err.toString() : err;
+}
+
+// results of the compression, taken from the workers once so the block cache sticks
+const CmdPackedText &Cmd::packedError() const
+{
+    packedOutput();
+    return packed_err;
+}
+
+const CmdPackedText &Cmd::packedOutput() const
+{
+    if (!packed_fetched) {
+        packed_out = out_packed.result();
+        packed_err = err_packed.result();
+        out_packed = QFuture<CmdPackedText>();
+        err_packed = QFuture<CmdPackedText>();
+        packed_fetched = true;
+    }
+    return packed_out;
+}
+
+// hand out/err to the thread pool for compression in line aligned blocks and drop them
+// here, the text is freed once the worker is done with its (implicitly shared) copy
+void Cmd::compressOutput()
+{
+    if (compressed) {
+        return;
+    }
+    const QString text_out = capturedOutput(), text_err = capturedError();
+    out_packed = QtConcurrent::run([text_out]() { CmdPackedText packed; packed.pack(text_out); return packed; });
+    err_packed = QtConcurrent::run([text_err]() { CmdPackedText packed; packed.pack(text_err); return packed; });
+    packed_fetched = false;
+    out.clear();
+    err.clear();
+    out_index.clear();
+    dedup_out.clear();
+    dedup_err.clear();
+    compressed = true;
+}
+
+// start the process and the tick timer, common part of run() and start();
+// cmd_str runs through bash unless argv is given, then it only describes the command
+bool Cmd::startProcess(const QString &cmd_str, const QStringList &argv, const QStringList &options, int est_duration)
+{
+    if (this->isRunning()) { // allow only one process at a time
+        if(debug >= 1) qDebug() << "process already running";
+        return false;
+    }
+
+    // reset variables if function is reused
+    this->est_duration = est_duration;
+    this->elapsed_time = 0;  // reset time counter
+    this->out.clear();
+    this->err.clear();
+    this->compressed = false;
+    packed_out.clear();
+    packed_err.clear();
+    out_index.clear();
+    out_search.clear();
+    filter_out.clear();
+    filter_err.clear();
+    this->search_out = options.contains("search");
+    this->dedup = options.contains("dedup");
+    this->discard = options.contains("discard");
+    dedup_out.clear();
+    dedup_err.clear();
+    this->compress_output = options.contains("compress");
+    this->stop_reason = NotStopped;
+    this->hash_out = options.contains("xxhash");
+    this->sha256_out = options.contains("sha256");
+    out_hash.reset();
+    out_sha256.reset();
+    this->stall_cpu = 0;
+    this->stall_reported = false;
+    this->last_activity.start();
+
+    // "background" runs with idle cpu and I/O priority, on top of the configured limits
+    CmdLimits run_limits = limits;
+    if (options.contains("background")) {
+        const CmdLimits background = CmdLimits::background();
+        run_limits.idle_sched = background.idle_sched;
+        run_limits.nice = background.nice;
+        run_limits.io_class = background.io_class;
+    }
+    proc->setLimits(run_limits);
+
+    proc_finished = false; // set by onFinished(), a mock backend can finish inside start()
+    start_failed = false;
+    if (recorder) recorder->beginRun(cmd_str);
+    if (argv.isEmpty()) {
+        proc->start("/bin/bash", QStringList() << "-c" << cmd_str);
+    } else {
+        proc->start(argv.first(), argv.mid(1));
+    }
+
+    // start timer when started
+    if (!proc->waitForStarted() && !this->isRunning() && !proc_finished) {
+        start_failed = true; // e.g. program not found, or elevation refused for the helper
+    }
+    emit started();
+
+    // baseline for the stall check, otherwise the first check always sees cpu advancing
+    if (stall_check_cpu && stall_timeout > 0 && this->isRunning()) {
+        stall_cpu = treeCpuTime(processTree(proc->processId()));
+    }
+
+    if (!this->isRunning()) {
+        // failed to start, nothing to time
+    } else if (options.contains("slowtick")) {
+        timer->start(1000);
+    } else {
+        timer->start(100);
+    }
+
+    if (!isQuiet(options)) qDebug() << cmd_str;
+    return true;
+}
+
+// "quiet" option only matters for debug level 2
+bool Cmd::isQuiet(const QStringList &options) const
+{
+    if (debug == 2) return options.contains("quiet");
+    return (debug < 2);
+}
+
 // control debugging messages
 void Cmd::setDebug(int level)
 {
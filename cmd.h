@@ -24,28 +24,74 @@
 #ifndef CMD_H
 #define CMD_H
 
+#include <QCryptographicHash>
+#include <QElapsedTimer>
 #include <QFile>
 #include <QFileSystemWatcher>
+#include <QFuture>
 #include <QProcess>
 #include <QTimer>
 #include <QTextStream>
 
 #include "cmd_global.h"
+#include "cmdbackend.h"
+#include "cmddedup.h"
+#include "cmdhash.h"
+#include "cmdlinefilter.h"
+#include "cmdlineindex.h"
+#include "cmdpackedtext.h"
+#include "cmdretry.h"
+#include "cmdsearchindex.h"
+
+class CmdRecorder;
+class QEventLoop;
 
 class CMDSHARED_EXPORT Cmd: public QObject
 {
     Q_OBJECT
 public:
+    enum StopReason { NotStopped, MemoryLimit, Stalled, Canceled }; // why the last run was ended early, Canceled by kill() or terminate()
+
     explicit Cmd(QObject *parent = 0);
     ~Cmd();
 
     bool isRunning() const;
+    bool setBackend(CmdBackend *backend); // takes ownership (deleted if refused while running), default is CmdProcessBackend
     bool connectFifo(const QString &file_name);
     int getExitCode(bool quiet = false) const;
+    // options: "quiet", "slowtick", "background" (idle cpu and I/O priority for the child),
+    //          "xxhash", "sha256" (hash stdout while it streams),
+    //          "compress" (keep the finished output compressed, unpacked on access),
+    //          "dedup" (store repeated consecutive lines once, see getCompactOutput()),
+    //          "search" (index stdout trigrams for findLines()),
+    //          "discard" (only stream the output, nothing is captured)
     int run(const QString &cmd_str, const QStringList &options = QStringList(""), int est_duration = 10); // with optional estimated time of completion
+    bool start(const QString &cmd_str, const QStringList &options = QStringList(""), int est_duration = 10); // like run() but returns immediately
+    int exec(const QStringList &argv, const QStringList &options = QStringList(""), int est_duration = 10); // no shell, e.g. CmdTemplate::argv()
     void disconnectFifo();
+    void setRecorder(CmdRecorder *recorder); // not owned, pass nullptr to stop recording
+    void setCpuAffinity(const QList<int> &cpus); // empty list for any cpu
+    void setLineFilter(const CmdLineFilter &filter); // default CmdLineFilter() keeps every line
+    CmdLineFilter getLineFilter() const;
+    void setLimits(const CmdLimits &limits); // applied in the child of the following runs
+    CmdLimits getLimits() const;
+    void setMemoryBudget(qint64 bytes); // kill the process tree above this RSS, 0 to disable
+    qint64 getMemoryBudget() const;
+    StopReason getStopReason() const;
+    // emit stalled() after secs without stdout/stderr (and cpu time, with check_cpu), 0 to disable
+    void setStallTimeout(int secs, bool terminate = true, bool check_cpu = false);
+    int getStallTimeout() const;
+    quint64 getOutputHash() const; // XXH64 of the raw stdout, 0 without "xxhash"
+    void setRetryPolicy(const CmdRetryPolicy &policy); // used by run(), waits without blocking the event loop
+    CmdRetryPolicy getRetryPolicy() const;
 
+    QByteArray getOutputSha256() const; // of the raw stdout, empty without "sha256"
+    QString getCompactOutput() const;
+    QVector<int> findLines(const QString &needle, Qt::CaseSensitivity cs = Qt::CaseSensitive) const;
     QString getError() const;
+    QString getLine(int n) const; // raw stdout line, not trimmed; no full rebuild with "dedup" or "compress"
+    QStringList getLines(int first, int count) const;
+    int getLineCount() const;
     QString getOutput() const;
     QString getOutput(const QString &cmd_str, const QStringList &options = QStringList(""), int est_duration = 10);
 
@@ -62,6 +108,7 @@ signals:
     void errorAvailable(const QString &err);
     void outputAvailable(const QString &out);
     void runTime(int, int); // runtime counter with estimated time
+    void stalled();
     void started();
 
 public slots:
@@ -74,22 +121,68 @@ public slots:
 
 private slots:
     void fifoChanged();
+    void onFinished(int exit_code, QProcess::ExitStatus exit_status);
     void onStdoutAvailable();
     void onStderrAvailable();
     void tick();      // slot called by timer
 
 private:
+    bool async = false; // started with start() and not finished yet
+    bool in_run = false; // inside run()'s event loop, it emits finished() itself
+    bool proc_finished = false, start_failed = false;
+    bool compress_output = false, compressed = false;
+    bool dedup = false, discard = false;
+    bool search_out = false;
+    bool hash_out = false, sha256_out = false;
+    bool stall_check_cpu = false, stall_reported = false, stall_terminate = true;
+    int stall_timeout = 0; // seconds without output before stalled(), 0 for none
     int debug = 2;    // debugging message control
     int elapsed_time; // elapsed running time
     int est_duration; // estimated completion time
     QFile fifo;       // named pipe used for interprocess communication
+    CmdLimits limits; // resource controls for the child
+    CmdDedupBuffer dedup_out, dedup_err;
+    CmdHash64 out_hash;
+    CmdLineFilter line_filter;
+    CmdLineIndex out_index; // line starts in out
+    CmdRetryPolicy retry_policy;
+    CmdSearchIndex out_search;
+    QCryptographicHash out_sha256;
+    mutable QFuture<CmdPackedText> out_packed, err_packed; // being compressed with "compress"
+    mutable CmdPackedText packed_out, packed_err;          // taken from the futures on first use
+    mutable bool packed_fetched = false;
+    StopReason stop_reason = NotStopped;
+    qint64 memory_budget = 0; // bytes of RSS for the whole process tree, 0 for none
+    qint64 stall_cpu = 0;     // cpu ticks of the process tree at the last activity
+    QElapsedTimer last_activity;
+    QEventLoop *retry_wait = nullptr; // backoff wait between retries in run()
     QFileSystemWatcher file_watch;
     QString out, err;
     QString line_out, line_err;
+    CmdLineSplitter filter_out, filter_err; // unterminated lines waiting for the line filter
     QTextStream buffer_out, buffer_err;
-    QProcess *proc;
+    CmdBackend *proc;
+    CmdRecorder *recorder = nullptr;
     QTimer *timer;
 
+    bool isQuiet(const QStringList &options) const;
+    QString capturedError() const;
+    QString capturedOutput() const;
+    const CmdPackedText &packedError() const;
+    const CmdPackedText &packedOutput() const;
+    void compressOutput();
+    void checkMemory();
+    void flushLineFilter();
+    void storeError(const QString &text);
+    void storeOutput(const QString &text);
+    void cancelRetry();
+    void checkStall();
+    void killTree(const QList<qint64> &pids);
+    bool startProcess(const QString &cmd_str, const QStringList &argv, const QStringList &options, int est_duration);
+    bool shouldRetry(int attempt, int exit_code) const;
+    int runAttempts(const QString &cmd_str, const QStringList &argv, const QStringList &options, int est_duration);
+    int runOnce(const QString &cmd_str, const QStringList &argv, const QStringList &options, int est_duration);
+
 };
 
 #endif // CMD_H
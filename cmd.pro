@@ -19,16 +19,58 @@
 # **********************************************************************/
 
 QT       -= gui
+QT       += network concurrent
 
 TARGET = cmd
 TEMPLATE = lib
+VERSION = 2.0.0 # soname libcmd.so.2, bump the major version whenever the layout of Cmd changes
+CONFIG += c++14
 
 DEFINES += CMD_LIBRARY
 
-SOURCES += cmd.cpp
+SOURCES += cmd.cpp \
+        cmdbackend.cpp \
+        cmdchecksum.cpp \
+        cmddedup.cpp \
+        cmddiff.cpp \
+        cmdhash.cpp \
+        cmdhelper.cpp \
+        cmdlinefilter.cpp \
+        cmdlineindex.cpp \
+        cmdlinesplitter.cpp \
+        cmdmock.cpp \
+        cmdoutputmodel.cpp \
+        cmdpackedtext.cpp \
+        cmdparallel.cpp \
+        cmdpoller.cpp \
+        cmdrecorder.cpp \
+        cmdretry.cpp \
+        cmdscheduler.cpp \
+        cmdsearchindex.cpp \
+        cmdtemplate.cpp
 
 HEADERS += cmd.h\
-        cmd_global.h
+        cmd_global.h \
+        cmdbackend.h \
+        cmdchecksum.h \
+        cmddedup.h \
+        cmddiff.h \
+        cmdhash.h \
+        cmdhelper.h \
+        cmdhelperprotocol.h \
+        cmdlinefilter.h \
+        cmdlineindex.h \
+        cmdlinesplitter.h \
+        cmdmock.h \
+        cmdoutputmodel.h \
+        cmdpackedtext.h \
+        cmdparallel.h \
+        cmdpoller.h \
+        cmdrecorder.h \
+        cmdretry.h \
+        cmdscheduler.h \
+        cmdsearchindex.h \
+        cmdtemplate.h
 
 unix {
     target.path = /usr/lib
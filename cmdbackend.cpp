@@ -0,0 +1,211 @@
+/**********************************************************************
+ *  cmdbackend.cpp
+ **********************************************************************
+ * Copyright (C) 2017 MX Authors
+ *
+ * Authors: Adrian
+ *          MX Linux <http://forum.mxlinux.org>
+ *
+ * This is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package. If not, see <http://www.gnu.org/licenses/>.
+ **********************************************************************/
+
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "cmdbackend.h"
+
+// QProcess that applies CmdLimits to the child between fork and exec, only
+// async-signal-safe calls are allowed in setupChildProcess() so everything is
+// converted to plain values beforehand
+class CmdChildProcess: public QProcess
+{
+public:
+    explicit CmdChildProcess(QObject *parent) :
+        QProcess(parent)
+    {
+        CPU_ZERO(&cpus);
+    }
+
+    bool idle_sched = false;
+    bool use_cpus = false;
+    int ioprio = -1;
+    int nice = CmdLimits::Keep;
+    rlim_t max_as = RLIM_INFINITY;
+    rlim_t max_cpu = RLIM_INFINITY;
+    rlim_t max_nofile = RLIM_INFINITY;
+    cpu_set_t cpus;
+
+protected:
+    void setupChildProcess()
+    {
+        if (max_as != RLIM_INFINITY) {
+            struct rlimit limit = { max_as, max_as };
+            setrlimit(RLIMIT_AS, &limit);
+        }
+        if (max_cpu != RLIM_INFINITY) {
+            struct rlimit limit = { max_cpu, max_cpu };
+            setrlimit(RLIMIT_CPU, &limit);
+        }
+        if (max_nofile != RLIM_INFINITY) {
+            struct rlimit limit = { max_nofile, max_nofile };
+            setrlimit(RLIMIT_NOFILE, &limit);
+        }
+        if (nice != CmdLimits::Keep) {
+            setpriority(PRIO_PROCESS, 0, nice);
+        }
+        if (ioprio >= 0) {
+            syscall(SYS_ioprio_set, 1, 0, ioprio); // IOPRIO_WHO_PROCESS, self
+        }
+        if (idle_sched) {
+            struct sched_param param = {};
+            sched_setscheduler(0, SCHED_IDLE, &param);
+        }
+        if (use_cpus) {
+            sched_setaffinity(0, sizeof(cpus), &cpus);
+        }
+    }
+};
+
+CmdLimits CmdLimits::background()
+{
+    CmdLimits limits;
+    limits.idle_sched = true;
+    limits.nice = 19; // in case SCHED_IDLE is refused
+    limits.io_class = IoIdle;
+    return limits;
+}
+
+CmdBackend::CmdBackend(QObject *parent) :
+    QObject(parent)
+{
+}
+
+CmdBackend::~CmdBackend()
+{
+}
+
+void CmdBackend::setLimits(const CmdLimits &)
+{
+}
+
+CmdProcessBackend::CmdProcessBackend(QObject *parent) :
+    CmdBackend(parent)
+{
+    proc = new CmdChildProcess(this);
+
+    connect(proc, static_cast<void (QProcess::*)(int, QProcess::ExitStatus)>(&QProcess::finished), this, &CmdBackend::finished);
+    connect(proc, &QProcess::readyReadStandardOutput, this, &CmdBackend::readyReadStandardOutput);
+    connect(proc, &QProcess::readyReadStandardError, this, &CmdBackend::readyReadStandardError);
+}
+
+// pause process
+bool CmdProcessBackend::pause()
+{
+    return (system("kill -STOP " + QByteArray::number(proc->processId())) == 0);
+}
+
+// resume process
+bool CmdProcessBackend::resume()
+{
+    return (system("kill -CONT " + QByteArray::number(proc->processId())) == 0);
+}
+
+bool CmdProcessBackend::waitForFinished(int msecs)
+{
+    return proc->waitForFinished(msecs);
+}
+
+bool CmdProcessBackend::waitForStarted(int msecs)
+{
+    return proc->waitForStarted(msecs);
+}
+
+int CmdProcessBackend::exitCode() const
+{
+    return proc->exitCode();
+}
+
+qint64 CmdProcessBackend::processId() const
+{
+    return proc->processId();
+}
+
+qint64 CmdProcessBackend::write(const QByteArray &data)
+{
+    return proc->write(data);
+}
+
+void CmdProcessBackend::kill()
+{
+    proc->kill();
+}
+
+void CmdProcessBackend::start(const QString &program, const QStringList &arguments)
+{
+    proc->start(program, arguments);
+}
+
+void CmdProcessBackend::terminate()
+{
+    proc->terminate();
+}
+
+void CmdProcessBackend::setLimits(const CmdLimits &limits)
+{
+    auto rlim = [](qint64 value) { return (value < 0) ? RLIM_INFINITY : rlim_t(value); };
+    proc->max_as = rlim(limits.max_address_space);
+    proc->max_cpu = rlim(limits.max_cpu_time);
+    proc->max_nofile = rlim(limits.max_open_files);
+    proc->nice = (limits.nice == CmdLimits::Keep) ? int(CmdLimits::Keep) : qBound(-20, limits.nice, 19);
+    proc->idle_sched = limits.idle_sched;
+    if (limits.io_class == CmdLimits::IoIdle) {
+        proc->ioprio = CmdLimits::IoIdle << 13;
+    } else if (limits.io_class > 0) {
+        proc->ioprio = (limits.io_class << 13) | qBound(0, limits.io_level, 7);
+    } else {
+        proc->ioprio = -1;
+    }
+    CPU_ZERO(&proc->cpus);
+    for (int cpu : limits.cpus) {
+        if (cpu >= 0 && cpu < CPU_SETSIZE) CPU_SET(cpu, &proc->cpus);
+    }
+    proc->use_cpus = (CPU_COUNT(&proc->cpus) > 0);
+}
+
+QByteArray CmdProcessBackend::readAllStandardError()
+{
+    return proc->readAllStandardError();
+}
+
+QByteArray CmdProcessBackend::readAllStandardOutput()
+{
+    return proc->readAllStandardOutput();
+}
+
+QProcess::ExitStatus CmdProcessBackend::exitStatus() const
+{
+    return proc->exitStatus();
+}
+
+QProcess::ProcessState CmdProcessBackend::state() const
+{
+    return proc->state();
+}
+
+QStringList CmdProcessBackend::arguments() const
+{
+    return proc->arguments();
+}
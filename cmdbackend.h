@@ -0,0 +1,119 @@
+/**********************************************************************
+ *  cmdbackend.h
+ **********************************************************************
+ * Copyright (C) 2017 MX Authors
+ *
+ * Authors: Adrian
+ *          MX Linux <http://forum.mxlinux.org>
+ *
+ * This is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package. If not, see <http://www.gnu.org/licenses/>.
+ **********************************************************************/
+
+
+#ifndef CMDBACKEND_H
+#define CMDBACKEND_H
+
+#include <QProcess>
+
+#include "cmd_global.h"
+
+class CmdChildProcess;
+
+// resource controls applied to the child between fork and exec,
+// negative values (Keep for nice) leave the inherited setting alone
+struct CMDSHARED_EXPORT CmdLimits
+{
+    enum { Keep = -100 };
+    enum IoClass { IoNone = -1, IoRealtime = 1, IoBestEffort = 2, IoIdle = 3 };
+
+    bool idle_sched = false; // SCHED_IDLE
+    int nice = Keep;         // -20..19
+    int io_class = IoNone;
+    int io_level = 4;        // 0 (highest) to 7, for realtime and best-effort
+    qint64 max_address_space = -1; // RLIMIT_AS, bytes
+    qint64 max_cpu_time = -1;      // RLIMIT_CPU, seconds
+    qint64 max_open_files = -1;    // RLIMIT_NOFILE
+    QList<int> cpus;               // affinity, empty for any cpu
+
+    // idle cpu and I/O priority, used by the "background" run option
+    static CmdLimits background();
+};
+
+// interface used by Cmd to start and control the command, lets the process
+// layer be swapped (e.g. for a mock that does not spawn anything)
+class CMDSHARED_EXPORT CmdBackend: public QObject
+{
+    Q_OBJECT
+public:
+    explicit CmdBackend(QObject *parent = 0);
+    virtual ~CmdBackend();
+
+    virtual bool pause() = 0;
+    virtual bool resume() = 0;
+    virtual bool waitForFinished(int msecs = 30000) = 0;
+    virtual bool waitForStarted(int msecs = 30000) = 0;
+    virtual int exitCode() const = 0;
+    virtual qint64 processId() const = 0;
+    virtual qint64 write(const QByteArray &data) = 0;
+    virtual void kill() = 0;
+    virtual void start(const QString &program, const QStringList &arguments) = 0;
+    virtual void terminate() = 0;
+
+    // limits for the next start(), ignored by backends without a real child
+    virtual void setLimits(const CmdLimits &limits);
+
+    virtual QByteArray readAllStandardError() = 0;
+    virtual QByteArray readAllStandardOutput() = 0;
+    virtual QProcess::ExitStatus exitStatus() const = 0;
+    virtual QProcess::ProcessState state() const = 0;
+    virtual QStringList arguments() const = 0;
+
+signals:
+    void finished(int exit_code, QProcess::ExitStatus exit_status);
+    void readyReadStandardError();
+    void readyReadStandardOutput();
+};
+
+// default backend, runs the command in a real child process
+class CMDSHARED_EXPORT CmdProcessBackend: public CmdBackend
+{
+    Q_OBJECT
+public:
+    explicit CmdProcessBackend(QObject *parent = 0);
+
+    bool pause();
+    bool resume();
+    bool waitForFinished(int msecs = 30000);
+    bool waitForStarted(int msecs = 30000);
+    int exitCode() const;
+    qint64 processId() const;
+    qint64 write(const QByteArray &data);
+    void kill();
+    void start(const QString &program, const QStringList &arguments);
+    void terminate();
+
+    void setLimits(const CmdLimits &limits);
+
+    QByteArray readAllStandardError();
+    QByteArray readAllStandardOutput();
+    QProcess::ExitStatus exitStatus() const;
+    QProcess::ProcessState state() const;
+    QStringList arguments() const;
+
+private:
+    CmdChildProcess *proc;
+
+};
+
+#endif // CMDBACKEND_H
@@ -0,0 +1,192 @@
+/**********************************************************************
+ *  cmdchecksum.cpp
+ **********************************************************************
+ * Copyright (C) 2017 MX Authors
+ *
+ * Authors: Adrian
+ *          MX Linux <http://forum.mxlinux.org>
+ *
+ * This is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package. If not, see <http://www.gnu.org/licenses/>.
+ **********************************************************************/
+
+#include "cmdchecksum.h"
+
+#include <QEventLoop>
+#include <QFile>
+#include <QFileInfo>
+#include <QTextStream>
+#include <QtConcurrent>
+
+static const qint64 block_size = 4 * 1024 * 1024; // hashed between progress and cancel checks
+
+CmdChecksum::CmdChecksum(QCryptographicHash::Algorithm algorithm, QObject *parent) :
+    QObject(parent),
+    algorithm(algorithm)
+{
+    connect(&watcher, &QFutureWatcher<QByteArray>::resultReadyAt, this, &CmdChecksum::onFileFinished);
+    connect(&watcher, &QFutureWatcher<QByteArray>::finished, this, &CmdChecksum::onFinished);
+    connect(&timer, &QTimer::timeout, this, &CmdChecksum::tick);
+}
+
+CmdChecksum::~CmdChecksum()
+{
+    cancel();
+    watcher.waitForFinished();
+}
+
+bool CmdChecksum::isRunning() const
+{
+    return watcher.isRunning();
+}
+
+bool CmdChecksum::start(const QStringList &files)
+{
+    if (isRunning()) {
+        return false;
+    }
+    this->files = files;
+    results.clear();
+    total = 0;
+    for (const QString &file_name : files) {
+        total += QFileInfo(file_name).size();
+    }
+    state = std::make_shared<Progress>();
+    const std::shared_ptr<Progress> state = this->state;
+    const QCryptographicHash::Algorithm algorithm = this->algorithm;
+    elapsed.start();
+    timer.start(1000);
+    watcher.setFuture(QtConcurrent::mapped(this->files, [state, algorithm](const QString &file_name) {
+        return hash(file_name, algorithm, state.get());
+    }));
+    return true;
+}
+
+QHash<QString, QByteArray> CmdChecksum::run(const QStringList &files)
+{
+    QEventLoop loop;
+    connect(this, &CmdChecksum::finished, &loop, &QEventLoop::quit);
+    if (!start(files)) {
+        return QHash<QString, QByteArray>(); // another job is running, its results aren't ours
+    }
+    loop.exec();
+    return results;
+}
+
+QHash<QString, QByteArray> CmdChecksum::getResults() const
+{
+    return results;
+}
+
+// "<digest>  <file>" lines, file names relative to the list's directory
+QStringList CmdChecksum::verify(const QString &sums_file)
+{
+    QFile file(sums_file);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        return QStringList(sums_file);
+    }
+    QHash<QString, QByteArray> expected;
+    const QString dir = QFileInfo(sums_file).absolutePath() + "/";
+    QTextStream stream(&file);
+    while (!stream.atEnd()) {
+        const QString line = stream.readLine().trimmed();
+        const int space = line.indexOf(' ');
+        if (line.isEmpty() || line.startsWith('#') || space < 0) {
+            continue;
+        }
+        QString name = line.mid(space + 1);
+        if (name.startsWith(' ') || name.startsWith('*')) { // text or binary mode marker
+            name.remove(0, 1);
+        }
+        if (!name.startsWith('/')) {
+            name.prepend(dir);
+        }
+        expected.insert(name, line.left(space).toLower().toLatin1());
+    }
+    const QHash<QString, QByteArray> digests = run(expected.keys());
+    QStringList failed;
+    for (auto it = expected.constBegin(); it != expected.constEnd(); ++it) {
+        if (digests.value(it.key()) != it.value()) {
+            failed << it.key();
+        }
+    }
+    failed.sort();
+    return failed;
+}
+
+QByteArray CmdChecksum::hashFile(const QString &file_name, QCryptographicHash::Algorithm algorithm)
+{
+    Progress state;
+    return hash(file_name, algorithm, &state);
+}
+
+void CmdChecksum::cancel()
+{
+    if (state) {
+        state->canceled = true;
+    }
+    watcher.cancel();
+}
+
+void CmdChecksum::onFileFinished(int index)
+{
+    const QByteArray digest = watcher.resultAt(index);
+    results.insert(files.at(index), digest);
+    emit fileFinished(files.at(index), digest);
+}
+
+void CmdChecksum::onFinished()
+{
+    timer.stop();
+    tick();
+    emit finished();
+}
+
+void CmdChecksum::tick()
+{
+    const qint64 done = state ? state->done.load() : 0;
+    const int secs = elapsed.elapsed() / 1000;
+    emit progress(done, total);
+    emit runTime(secs, done > 0 ? int(secs * total / done) : 0);
+}
+
+// hash from mapped memory in blocks, reading blocks instead if the file can't be mapped
+QByteArray CmdChecksum::hash(const QString &file_name, QCryptographicHash::Algorithm algorithm, Progress *state)
+{
+    QFile file(file_name);
+    if (state->canceled || !file.open(QIODevice::ReadOnly)) {
+        return QByteArray();
+    }
+    QCryptographicHash sum(algorithm);
+    const qint64 size = file.size();
+    uchar *data = size > 0 ? file.map(0, size) : nullptr;
+    if (data) {
+        for (qint64 pos = 0; pos < size; pos += block_size) {
+            if (state->canceled) return QByteArray();
+            const qint64 len = qMin(block_size, size - pos);
+            sum.addData(reinterpret_cast<const char *>(data + pos), int(len));
+            state->done += len;
+        }
+        file.unmap(data);
+    } else {
+        QByteArray block(block_size, Qt::Uninitialized);
+        qint64 len;
+        while ((len = file.read(block.data(), block_size)) > 0) {
+            if (state->canceled) return QByteArray();
+            sum.addData(block.constData(), int(len));
+            state->done += len;
+        }
+        if (len < 0) return QByteArray();
+    }
+    return sum.result().toHex();
+}
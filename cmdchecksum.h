@@ -0,0 +1,92 @@
+/**********************************************************************
+ *  cmdchecksum.h
+ **********************************************************************
+ * Copyright (C) 2017 MX Authors
+ *
+ * Authors: Adrian
+ *          MX Linux <http://forum.mxlinux.org>
+ *
+ * This is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package. If not, see <http://www.gnu.org/licenses/>.
+ **********************************************************************/
+
+
+#ifndef CMDCHECKSUM_H
+#define CMDCHECKSUM_H
+
+#include <QCryptographicHash>
+#include <QElapsedTimer>
+#include <QFutureWatcher>
+#include <QHash>
+#include <QTimer>
+
+#include <atomic>
+#include <memory>
+
+#include "cmd_global.h"
+
+// checksums of files computed in this process instead of running md5sum/sha256sum,
+// files are hashed in parallel on the global thread pool from mapped memory (or
+// large reads when mapping fails); digests are lowercase hex like the tools print
+class CMDSHARED_EXPORT CmdChecksum: public QObject
+{
+    Q_OBJECT
+public:
+    explicit CmdChecksum(QCryptographicHash::Algorithm algorithm = QCryptographicHash::Sha256, QObject *parent = 0);
+    ~CmdChecksum();
+
+    bool isRunning() const;
+    bool start(const QStringList &files); // returns immediately, finished() when done
+    // blocks; empty digest for unreadable files, empty hash if a job is already running
+    QHash<QString, QByteArray> run(const QStringList &files);
+    QHash<QString, QByteArray> getResults() const;
+
+    // files of a "sha256sum -c" style list whose digest doesn't match or can't be read
+    QStringList verify(const QString &sums_file);
+
+    static QByteArray hashFile(const QString &file_name, QCryptographicHash::Algorithm algorithm);
+
+signals:
+    void fileFinished(const QString &file_name, const QByteArray &digest);
+    void finished();
+    void progress(qint64 bytes_done, qint64 bytes_total);
+    void runTime(int, int); // elapsed and estimated seconds, like Cmd::runTime()
+
+public slots:
+    void cancel();
+
+private slots:
+    void onFileFinished(int index);
+    void onFinished();
+    void tick();
+
+private:
+    struct Progress
+    {
+        std::atomic<bool> canceled{false};
+        std::atomic<qint64> done{0};
+    };
+
+    qint64 total = 0; // bytes of all files
+    QCryptographicHash::Algorithm algorithm;
+    QElapsedTimer elapsed;
+    QFutureWatcher<QByteArray> watcher;
+    QHash<QString, QByteArray> results;
+    QStringList files;
+    QTimer timer;
+    std::shared_ptr<Progress> state;
+
+    static QByteArray hash(const QString &file_name, QCryptographicHash::Algorithm algorithm, Progress *state);
+};
+
+#endif // CMDCHECKSUM_H
@@ -0,0 +1,138 @@
+/**********************************************************************
+ *  cmddedup.cpp
+ **********************************************************************
+ * Copyright (C) 2017 MX Authors
+ *
+ * Authors: Adrian
+ *          MX Linux <http://forum.mxlinux.org>
+ *
+ * This is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package. If not, see <http://www.gnu.org/licenses/>.
+ **********************************************************************/
+
+#include "cmddedup.h"
+
+#include <algorithm>
+
+CmdDedupBuffer::CmdDedupBuffer(int dictionary_size) :
+    dictionary_size(qMax(0, dictionary_size))
+{
+}
+
+bool CmdDedupBuffer::isEmpty() const
+{
+    return runs.isEmpty() && !splitter.hasPartial();
+}
+
+int CmdDedupBuffer::lineCount() const
+{
+    return splitter.hasPartial() ? lines + 1 : lines;
+}
+
+int CmdDedupBuffer::runCount() const
+{
+    return runs.size();
+}
+
+QString CmdDedupBuffer::line(int n) const
+{
+    if (n < 0 || n >= lineCount()) {
+        return QString();
+    }
+    if (n == lines) {
+        return splitter.partial();
+    }
+    return runs.at(int(std::upper_bound(ends.cbegin(), ends.cend(), n) - ends.cbegin())).line;
+}
+
+void CmdDedupBuffer::append(const QString &chunk)
+{
+    splitter.split(chunk, [this](const QString &line) {
+        ++lines;
+        if (!runs.isEmpty() && runs.last().line == line) {
+            ++runs.last().count;
+            ++ends.last();
+        } else {
+            runs.append(Run{intern(line), 1});
+            ends.append(lines);
+        }
+    });
+}
+
+void CmdDedupBuffer::clear()
+{
+    lines = 0;
+    dictionary.clear();
+    ends.clear();
+    splitter.clear();
+    runs.clear();
+}
+
+QString CmdDedupBuffer::toCompactString() const
+{
+    QString text;
+    for (const Run &run : runs) {
+        text += run.line;
+        if (run.count > 1) {
+            text += QString(" [repeated %1 times]").arg(run.count);
+        }
+        text += '\n';
+    }
+    return text + splitter.partial();
+}
+
+QString CmdDedupBuffer::toString() const
+{
+    const QString partial = splitter.partial();
+    int size = partial.size();
+    for (const Run &run : runs) {
+        size += (run.line.size() + 1) * run.count;
+    }
+    QString text;
+    text.reserve(size);
+    for (const Run &run : runs) {
+        for (int i = 0; i < run.count; ++i) {
+            text += run.line;
+            text += '\n';
+        }
+    }
+    return text + partial;
+}
+
+// shared copy of a line seen before; when the dictionary is full, lines seen only
+// once are evicted and the other counts halved so it keeps the frequent ones
+QString CmdDedupBuffer::intern(const QString &line)
+{
+    if (dictionary_size == 0) {
+        return line;
+    }
+    auto it = dictionary.find(line);
+    if (it != dictionary.end()) {
+        ++it.value();
+        return it.key();
+    }
+    if (dictionary.size() >= dictionary_size) {
+        for (it = dictionary.begin(); it != dictionary.end();) {
+            if (it.value() <= 1) {
+                it = dictionary.erase(it);
+            } else {
+                it.value() /= 2;
+                ++it;
+            }
+        }
+    }
+    if (dictionary.size() < dictionary_size) {
+        dictionary.insert(line, 1);
+    }
+    return line;
+}
@@ -0,0 +1,69 @@
+/**********************************************************************
+ *  cmddedup.h
+ **********************************************************************
+ * Copyright (C) 2017 MX Authors
+ *
+ * Authors: Adrian
+ *          MX Linux <http://forum.mxlinux.org>
+ *
+ * This is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package. If not, see <http://www.gnu.org/licenses/>.
+ **********************************************************************/
+
+
+#ifndef CMDDEDUP_H
+#define CMDDEDUP_H
+
+#include <QHash>
+#include <QString>
+#include <QVector>
+
+#include "cmd_global.h"
+#include "cmdlinesplitter.h"
+
+// line storage for captured output: consecutive duplicate lines are kept once with
+// a repeat count, and frequent lines are interned in a bounded dictionary so their
+// later occurrences share one copy; toString() rebuilds the exact text
+class CMDSHARED_EXPORT CmdDedupBuffer
+{
+public:
+    explicit CmdDedupBuffer(int dictionary_size = 256);
+
+    bool isEmpty() const;
+    int lineCount() const; // repeats included, an unterminated last line counts
+    int runCount() const;  // lines actually stored
+    QString line(int n) const; // without the newline, found by binary search over the runs
+    void append(const QString &chunk); // lines may span chunks
+    void clear();
+
+    QString toCompactString() const; // repeats folded into "line [repeated n times]"
+    QString toString() const;
+
+private:
+    struct Run
+    {
+        QString line;
+        int count;
+    };
+
+    int dictionary_size;
+    int lines = 0;
+    QHash<QString, int> dictionary; // interned line -> hits
+    QVector<int> ends; // lines up to and including each run
+    CmdLineSplitter splitter; // holds the last line until its newline arrives
+    QVector<Run> runs;
+
+    QString intern(const QString &line);
+};
+
+#endif // CMDDEDUP_H
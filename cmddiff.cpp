@@ -0,0 +1,132 @@
+/**********************************************************************
+ *  cmddiff.cpp
+ **********************************************************************
+ * Copyright (C) 2017 MX Authors
+ *
+ * Authors: Adrian
+ *          MX Linux <http://forum.mxlinux.org>
+ *
+ * This is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package. If not, see <http://www.gnu.org/licenses/>.
+ **********************************************************************/
+
+#include <QHash>
+
+#include "cmddiff.h"
+
+// largest middle section (old x new rows) aligned line by line, bigger rewrites
+// are reported as one block change
+static const qint64 max_cells = 1000000;
+
+static QVector<uint> lineHashes(const QStringList &lines)
+{
+    QVector<uint> hashes;
+    hashes.reserve(lines.size());
+    for (const QString &line : lines) {
+        hashes << qHash(line);
+    }
+    return hashes;
+}
+
+// the output split the same way getOutput() users usually do
+QList<CmdDelta> CmdLineDiff::update(const QString &output)
+{
+    QStringList new_lines = output.isEmpty() ? QStringList() : output.split('\n');
+    QVector<uint> new_hashes = lineHashes(new_lines);
+    const QList<CmdDelta> deltas = diff(lines, hashes, new_lines, new_hashes);
+    lines.swap(new_lines);
+    hashes.swap(new_hashes);
+    return deltas;
+}
+
+QStringList CmdLineDiff::getLines() const
+{
+    return lines;
+}
+
+void CmdLineDiff::reset()
+{
+    lines.clear();
+    hashes.clear();
+}
+
+QList<CmdDelta> CmdLineDiff::diff(const QStringList &old_lines, const QStringList &new_lines)
+{
+    return diff(old_lines, lineHashes(old_lines), new_lines, lineHashes(new_lines));
+}
+
+QList<CmdDelta> CmdLineDiff::diff(const QStringList &old_lines, const QVector<uint> &old_hashes,
+                                  const QStringList &new_lines, const QVector<uint> &new_hashes)
+{
+    auto same = [&](int i, int j) {
+        return (old_hashes.at(i) == new_hashes.at(j) && old_lines.at(i) == new_lines.at(j));
+    };
+
+    // common head and tail are the usual case for polled output
+    int head = 0;
+    while (head < old_lines.size() && head < new_lines.size() && same(head, head)) {
+        ++head;
+    }
+    int tail = 0;
+    while (tail < old_lines.size() - head && tail < new_lines.size() - head
+           && same(old_lines.size() - 1 - tail, new_lines.size() - 1 - tail)) {
+        ++tail;
+    }
+    const int n = old_lines.size() - head - tail;
+    const int m = new_lines.size() - head - tail;
+
+    // alignment of the middle: true keeps an old/new pair, runs in between are edits
+    QVector<QPair<int, int>> matches; // (old index, new index) of kept lines
+    if (n > 0 && m > 0 && qint64(n) * m <= max_cells) {
+        QVector<int> lcs((n + 1) * (m + 1), 0); // longest common subsequence of the suffixes
+        for (int i = n - 1; i >= 0; --i) {
+            for (int j = m - 1; j >= 0; --j) {
+                lcs[i * (m + 1) + j] = same(head + i, head + j) ? lcs[(i + 1) * (m + 1) + j + 1] + 1
+                        : qMax(lcs[(i + 1) * (m + 1) + j], lcs[i * (m + 1) + j + 1]);
+            }
+        }
+        int i = 0, j = 0;
+        while (i < n && j < m) {
+            if (same(head + i, head + j)) {
+                matches << qMakePair(head + i++, head + j++);
+            } else if (lcs[(i + 1) * (m + 1) + j] >= lcs[i * (m + 1) + j + 1]) {
+                ++i;
+            } else {
+                ++j;
+            }
+        }
+    }
+    matches << qMakePair(old_lines.size() - tail, new_lines.size() - tail); // sentinel
+
+    // turn the gaps between kept lines into deltas, pairing removed and inserted rows as changes
+    QList<CmdDelta> deltas;
+    int old_pos = head, new_pos = head;
+    for (const auto &match : matches) {
+        const int removed = match.first - old_pos;
+        const int inserted = match.second - new_pos;
+        const int changed = qMin(removed, inserted);
+        if (changed > 0) {
+            deltas << CmdDelta{CmdDelta::Change, new_pos, changed, new_lines.mid(new_pos, changed)};
+        }
+        if (removed > changed) {
+            deltas << CmdDelta{CmdDelta::Remove, new_pos + changed, removed - changed, QStringList()};
+        }
+        if (inserted > changed) {
+            deltas << CmdDelta{CmdDelta::Insert, new_pos + changed, inserted - changed,
+                               new_lines.mid(new_pos + changed, inserted - changed)};
+        }
+        old_pos = match.first + 1;
+        new_pos = match.second + 1;
+    }
+    return deltas;
+}
@@ -0,0 +1,64 @@
+/**********************************************************************
+ *  cmddiff.h
+ **********************************************************************
+ * Copyright (C) 2017 MX Authors
+ *
+ * Authors: Adrian
+ *          MX Linux <http://forum.mxlinux.org>
+ *
+ * This is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package. If not, see <http://www.gnu.org/licenses/>.
+ **********************************************************************/
+
+
+#ifndef CMDDIFF_H
+#define CMDDIFF_H
+
+#include <QList>
+#include <QStringList>
+#include <QVector>
+
+#include "cmd_global.h"
+
+// one edit of a line list, deltas are applied in order and "position" is the row
+// in the list as it is after the previous deltas (i.e. model row numbers)
+struct CmdDelta
+{
+    enum Type { Insert, Remove, Change };
+
+    Type type;
+    int position;
+    int count;         // rows affected
+    QStringList lines; // new rows for Insert and Change
+};
+
+// compares successive outputs of a command line by line (by hash first) so views
+// can apply compact insert/remove/change deltas instead of rebuilding
+class CMDSHARED_EXPORT CmdLineDiff
+{
+public:
+    QList<CmdDelta> update(const QString &output); // deltas from the previous output
+    QStringList getLines() const;
+    void reset();
+
+    static QList<CmdDelta> diff(const QStringList &old_lines, const QStringList &new_lines);
+
+private:
+    QStringList lines;
+    QVector<uint> hashes;
+
+    static QList<CmdDelta> diff(const QStringList &old_lines, const QVector<uint> &old_hashes,
+                                const QStringList &new_lines, const QVector<uint> &new_hashes);
+};
+
+#endif // CMDDIFF_H
@@ -0,0 +1,151 @@
+/**********************************************************************
+ *  cmdhash.cpp
+ **********************************************************************
+ * Copyright (C) 2017 MX Authors
+ *
+ * Authors: Adrian
+ *          MX Linux <http://forum.mxlinux.org>
+ *
+ * This is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package. If not, see <http://www.gnu.org/licenses/>.
+ **********************************************************************/
+
+#include <QtEndian>
+
+#include <cstring>
+
+#include "cmdhash.h"
+
+static const quint64 prime1 = 11400714785074694791ULL;
+static const quint64 prime2 = 14029467366897019727ULL;
+static const quint64 prime3 = 1609587929392839161ULL;
+static const quint64 prime4 = 9650029242287828579ULL;
+static const quint64 prime5 = 2870177450012600261ULL;
+
+static inline quint64 rotl(quint64 x, int r)
+{
+    return (x << r) | (x >> (64 - r));
+}
+
+static inline quint64 read64(const unsigned char *p)
+{
+    quint64 value;
+    memcpy(&value, p, sizeof(value));
+    return qFromLittleEndian(value);
+}
+
+static inline quint32 read32(const unsigned char *p)
+{
+    quint32 value;
+    memcpy(&value, p, sizeof(value));
+    return qFromLittleEndian(value);
+}
+
+static inline quint64 hashRound(quint64 acc, quint64 input)
+{
+    acc += input * prime2;
+    return rotl(acc, 31) * prime1;
+}
+
+static inline quint64 mergeRound(quint64 acc, quint64 value)
+{
+    acc ^= hashRound(0, value);
+    return acc * prime1 + prime4;
+}
+
+CmdHash64::CmdHash64(quint64 seed) :
+    seed(seed)
+{
+    reset();
+}
+
+// hash of the data added so far, more data can still be added afterwards
+quint64 CmdHash64::result() const
+{
+    quint64 h;
+    if (total >= 32) {
+        h = rotl(v[0], 1) + rotl(v[1], 7) + rotl(v[2], 12) + rotl(v[3], 18);
+        for (quint64 lane : v) {
+            h = mergeRound(h, lane);
+        }
+    } else {
+        h = seed + prime5;
+    }
+    h += total;
+
+    const unsigned char *p = buffer;
+    const unsigned char *end = buffer + buffered;
+    for (; p + 8 <= end; p += 8) {
+        h ^= hashRound(0, read64(p));
+        h = rotl(h, 27) * prime1 + prime4;
+    }
+    if (p + 4 <= end) {
+        h ^= quint64(read32(p)) * prime1;
+        h = rotl(h, 23) * prime2 + prime3;
+        p += 4;
+    }
+    for (; p < end; ++p) {
+        h ^= *p * prime5;
+        h = rotl(h, 11) * prime1;
+    }
+
+    h ^= h >> 33;
+    h *= prime2;
+    h ^= h >> 29;
+    h *= prime3;
+    h ^= h >> 32;
+    return h;
+}
+
+void CmdHash64::addData(const char *data, qint64 length)
+{
+    if (length <= 0) {
+        return;
+    }
+    const unsigned char *p = reinterpret_cast<const unsigned char *>(data);
+    const unsigned char *end = p + length;
+    total += length;
+
+    if (buffered + length < 32) { // not enough for a stripe yet
+        memcpy(buffer + buffered, p, length);
+        buffered += int(length);
+        return;
+    }
+    if (buffered > 0) {
+        memcpy(buffer + buffered, p, 32 - buffered);
+        p += 32 - buffered;
+        for (int i = 0; i < 4; ++i) {
+            v[i] = hashRound(v[i], read64(buffer + 8 * i));
+        }
+        buffered = 0;
+    }
+    for (; p + 32 <= end; p += 32) {
+        for (int i = 0; i < 4; ++i) {
+            v[i] = hashRound(v[i], read64(p + 8 * i));
+        }
+    }
+    if (p < end) {
+        buffered = int(end - p);
+        memcpy(buffer, p, buffered);
+    }
+}
+
+void CmdHash64::reset()
+{
+    total = 0;
+    buffered = 0;
+    v[0] = seed + prime1 + prime2;
+    v[1] = seed + prime2;
+    v[2] = seed;
+    v[3] = seed - prime1;
+}
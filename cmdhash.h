@@ -0,0 +1,49 @@
+/**********************************************************************
+ *  cmdhash.h
+ **********************************************************************
+ * Copyright (C) 2017 MX Authors
+ *
+ * Authors: Adrian
+ *          MX Linux <http://forum.mxlinux.org>
+ *
+ * This is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package. If not, see <http://www.gnu.org/licenses/>.
+ **********************************************************************/
+
+
+#ifndef CMDHASH_H
+#define CMDHASH_H
+
+#include <QtGlobal>
+
+#include "cmd_global.h"
+
+// streaming XXH64, a fast non-cryptographic hash for change detection
+class CMDSHARED_EXPORT CmdHash64
+{
+public:
+    explicit CmdHash64(quint64 seed = 0);
+
+    quint64 result() const;
+    void addData(const char *data, qint64 length);
+    void reset();
+
+private:
+    quint64 seed;
+    quint64 total;
+    quint64 v[4];
+    unsigned char buffer[32];
+    int buffered;
+};
+
+#endif // CMDHASH_H
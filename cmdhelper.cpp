@@ -0,0 +1,316 @@
+/**********************************************************************
+ *  cmdhelper.cpp
+ **********************************************************************
+ * Copyright (C) 2017 MX Authors
+ *
+ * Authors: Adrian
+ *          MX Linux <http://forum.mxlinux.org>
+ *
+ * This is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package. If not, see <http://www.gnu.org/licenses/>.
+ **********************************************************************/
+
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QFile>
+#include <QTimer>
+
+#include <signal.h>
+#include <unistd.h>
+
+#include "cmdhelper.h"
+#include "cmdhelperprotocol.h"
+
+using namespace CmdHelperProtocol;
+
+static const char *helper_path = "/usr/lib/libcmd/cmd-helper";
+static const int started_timeout = 5000; // the helper answers Start as soon as its QProcess started
+static QByteArray session_token; // given to the helper this process started, kept in memory only
+
+static QString helperSocket()
+{
+    return socketPath(getuid(), getpid());
+}
+
+CmdHelperBackend::CmdHelperBackend(QObject *parent) :
+    CmdBackend(parent)
+{
+    socket = new QLocalSocket(this);
+    connect(socket, &QLocalSocket::readyRead, this, &CmdHelperBackend::onReadyRead);
+    connect(socket, &QLocalSocket::disconnected, this, &CmdHelperBackend::onDisconnected);
+}
+
+bool CmdHelperBackend::pause()
+{
+    return sendSignal(SIGSTOP);
+}
+
+bool CmdHelperBackend::resume()
+{
+    return sendSignal(SIGCONT);
+}
+
+bool CmdHelperBackend::waitForFinished(int msecs)
+{
+    if (proc_state == QProcess::NotRunning) {
+        return false;
+    }
+    QEventLoop loop;
+    connect(this, &CmdBackend::finished, &loop, &QEventLoop::quit);
+    connect(socket, &QLocalSocket::disconnected, &loop, &QEventLoop::quit);
+    if (msecs >= 0) {
+        QTimer::singleShot(msecs, &loop, &QEventLoop::quit);
+    }
+    loop.exec();
+    return (proc_state == QProcess::NotRunning);
+}
+
+// the Started reply carries the pid of the root process; blocks without an event loop,
+// so only on a live connection and for a few seconds at most, a later reply is still
+// handled through the event loop
+bool CmdHelperBackend::waitForStarted(int msecs)
+{
+    if (proc_state == QProcess::Starting && socket->state() == QLocalSocket::ConnectedState) {
+        msecs = (msecs < 0) ? started_timeout : qMin(msecs, started_timeout);
+        waiting_start = true;
+        QElapsedTimer waited;
+        waited.start();
+        while (proc_state == QProcess::Starting && !waited.hasExpired(msecs)) {
+            if (!socket->waitForReadyRead(int(qMax(qint64(1), msecs - waited.elapsed())))) {
+                break;
+            }
+        }
+        waiting_start = false;
+    }
+    return (proc_state == QProcess::Running);
+}
+
+int CmdHelperBackend::exitCode() const
+{
+    return exit_code;
+}
+
+qint64 CmdHelperBackend::processId() const
+{
+    return (proc_state == QProcess::NotRunning) ? 0 : pid;
+}
+
+qint64 CmdHelperBackend::write(const QByteArray &data)
+{
+    if (proc_state != QProcess::Running) {
+        return -1;
+    }
+    socket->write(frame(Write, encode(data)));
+    return data.size();
+}
+
+void CmdHelperBackend::kill()
+{
+    sendSignal(SIGKILL);
+}
+
+// connects to the helper, starting it first if needed (this asks for the password)
+void CmdHelperBackend::start(const QString &program, const QStringList &arguments)
+{
+    if (proc_state != QProcess::NotRunning) {
+        return;
+    }
+    args = arguments;
+    pid = 0;
+    exit_code = -1; // until the helper reports the exit, any failure to get there is a crash
+    exit_status = QProcess::CrashExit;
+    buffer.clear();
+    buffer_out.clear();
+    buffer_err.clear();
+
+    socket->abort();
+    socket->connectToServer(helperSocket());
+    if (!socket->waitForConnected(1000)) {
+        if (!startHelper()) {
+            qDebug() << "could not start privileged helper";
+            return;
+        }
+        socket->connectToServer(helperSocket());
+        if (!socket->waitForConnected(1000)) {
+            qDebug() << "could not connect to privileged helper:" << socket->errorString();
+            return;
+        }
+    }
+    proc_state = QProcess::Starting;
+    socket->write(frame(Start, encode(session_token, program, arguments)));
+    socket->flush();
+}
+
+void CmdHelperBackend::terminate()
+{
+    sendSignal(SIGTERM);
+}
+
+QByteArray CmdHelperBackend::readAllStandardError()
+{
+    QByteArray data;
+    data.swap(buffer_err);
+    return data;
+}
+
+QByteArray CmdHelperBackend::readAllStandardOutput()
+{
+    QByteArray data;
+    data.swap(buffer_out);
+    return data;
+}
+
+QProcess::ExitStatus CmdHelperBackend::exitStatus() const
+{
+    return exit_status;
+}
+
+QProcess::ProcessState CmdHelperBackend::state() const
+{
+    return proc_state;
+}
+
+QStringList CmdHelperBackend::arguments() const
+{
+    return args;
+}
+
+bool CmdHelperBackend::isHelperRunning()
+{
+    if (session_token.isEmpty()) {
+        return false;
+    }
+    QLocalSocket probe;
+    probe.connectToServer(helperSocket());
+    return probe.waitForConnected(200);
+}
+
+// one pkexec elevation for the whole session, the helper exits by itself when idle;
+// pkexec exits once the helper listens, or with an error if authentication failed
+bool CmdHelperBackend::startHelper(int msecs)
+{
+    if (isHelperRunning()) {
+        return true;
+    }
+    QFile random("/dev/urandom");
+    if (!random.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    session_token = random.read(32).toHex();
+    if (session_token.size() != 64) {
+        session_token.clear();
+        return false;
+    }
+
+    QProcess pkexec;
+    pkexec.start("pkexec", QStringList() << helper_path);
+    if (!pkexec.waitForStarted()) {
+        session_token.clear();
+        return false;
+    }
+    pkexec.write(session_token + "\n" + QByteArray::number(qint64(getpid())) + "\n");
+    pkexec.closeWriteChannel();
+
+    QEventLoop loop; // keeps the GUI responsive during the authentication dialog
+    connect(&pkexec, static_cast<void (QProcess::*)(int, QProcess::ExitStatus)>(&QProcess::finished), &loop, &QEventLoop::quit);
+    QTimer::singleShot(msecs, &loop, &QEventLoop::quit);
+    if (pkexec.state() != QProcess::NotRunning) {
+        loop.exec();
+    }
+    if (pkexec.state() != QProcess::NotRunning) {
+        qDebug() << "no answer to the authentication request";
+        pkexec.kill();
+        pkexec.waitForFinished(1000);
+    } else if (pkexec.exitStatus() != QProcess::NormalExit || pkexec.exitCode() != 0) {
+        qDebug() << "pkexec failed with exit code" << pkexec.exitCode(); // 126 dismissed, 127 not authorized
+    } else if (isHelperRunning()) {
+        return true;
+    }
+    session_token.clear();
+    return false;
+}
+
+// helper went away, report the command as crashed
+void CmdHelperBackend::onDisconnected()
+{
+    if (proc_state != QProcess::NotRunning) {
+        finish(-1, QProcess::CrashExit);
+    }
+}
+
+void CmdHelperBackend::onReadyRead()
+{
+    buffer += socket->readAll();
+    quint8 type;
+    QByteArray payload;
+    while (takeFrame(buffer, type, payload)) {
+        QDataStream stream(payload);
+        stream.setVersion(QDataStream::Qt_5_0);
+        switch (type) {
+        case Started:
+            stream >> pid;
+            proc_state = QProcess::Running;
+            break;
+        case Output: {
+            QByteArray data;
+            stream >> data;
+            buffer_out += data;
+            emit readyReadStandardOutput();
+            break;
+        }
+        case Error: {
+            QByteArray data;
+            stream >> data;
+            buffer_err += data;
+            emit readyReadStandardError();
+            break;
+        }
+        case Finished: {
+            qint32 code, status;
+            stream >> code >> status;
+            finish(code, static_cast<QProcess::ExitStatus>(status));
+            break;
+        }
+        case FailedToStart:
+            if (waiting_start) { // waitForStarted() returns false, like QProcess
+                exit_code = -1;
+                exit_status = QProcess::CrashExit;
+                proc_state = QProcess::NotRunning;
+            } else { // the caller already waits for finished()
+                finish(-1, QProcess::CrashExit);
+            }
+            break;
+        default:
+            qDebug() << "unknown message from privileged helper:" << type;
+        }
+    }
+}
+
+bool CmdHelperBackend::sendSignal(int sig)
+{
+    if (proc_state != QProcess::Running) {
+        return false;
+    }
+    socket->write(frame(Signal, encode(qint32(sig))));
+    socket->flush();
+    return true;
+}
+
+void CmdHelperBackend::finish(int exit_code, QProcess::ExitStatus exit_status)
+{
+    this->exit_code = exit_code;
+    this->exit_status = exit_status;
+    proc_state = QProcess::NotRunning;
+    emit finished(exit_code, exit_status);
+}
@@ -0,0 +1,79 @@
+/**********************************************************************
+ *  cmdhelper.h
+ **********************************************************************
+ * Copyright (C) 2017 MX Authors
+ *
+ * Authors: Adrian
+ *          MX Linux <http://forum.mxlinux.org>
+ *
+ * This is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package. If not, see <http://www.gnu.org/licenses/>.
+ **********************************************************************/
+
+
+#ifndef CMDHELPER_H
+#define CMDHELPER_H
+
+#include <QLocalSocket>
+
+#include "cmdbackend.h"
+
+// backend running commands as root through the cmd-helper daemon: the helper is
+// started once per session with pkexec and accepts commands over a Unix socket
+// only with the random token this process handed it, so each privileged command
+// does not pay for its own elevation and other programs can't borrow it
+class CMDSHARED_EXPORT CmdHelperBackend: public CmdBackend
+{
+    Q_OBJECT
+public:
+    explicit CmdHelperBackend(QObject *parent = 0);
+
+    bool pause();
+    bool resume();
+    bool waitForFinished(int msecs = 30000);
+    bool waitForStarted(int msecs = 30000);
+    int exitCode() const;
+    qint64 processId() const;
+    qint64 write(const QByteArray &data);
+    void kill();
+    void start(const QString &program, const QStringList &arguments);
+    void terminate();
+
+    QByteArray readAllStandardError();
+    QByteArray readAllStandardOutput();
+    QProcess::ExitStatus exitStatus() const;
+    QProcess::ProcessState state() const;
+    QStringList arguments() const;
+
+    static bool isHelperRunning();
+    static bool startHelper(int msecs = 60000); // waits for the authentication dialog, false if refused
+
+private slots:
+    void onDisconnected();
+    void onReadyRead();
+
+private:
+    bool waiting_start = false; // inside waitForStarted()
+    int exit_code = 0;
+    qint64 pid = 0;
+    QByteArray buffer, buffer_out, buffer_err;
+    QLocalSocket *socket;
+    QProcess::ExitStatus exit_status = QProcess::NormalExit;
+    QProcess::ProcessState proc_state = QProcess::NotRunning;
+    QStringList args;
+
+    bool sendSignal(int sig);
+    void finish(int exit_code, QProcess::ExitStatus exit_status);
+};
+
+#endif // CMDHELPER_H
@@ -0,0 +1,95 @@
+/**********************************************************************
+ *  cmdhelperprotocol.h
+ **********************************************************************
+ * Copyright (C) 2017 MX Authors
+ *
+ * Authors: Adrian
+ *          MX Linux <http://forum.mxlinux.org>
+ *
+ * This is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package. If not, see <http://www.gnu.org/licenses/>.
+ **********************************************************************/
+
+
+#ifndef CMDHELPERPROTOCOL_H
+#define CMDHELPERPROTOCOL_H
+
+#include <QByteArray>
+#include <QDataStream>
+#include <QString>
+#include <QtEndian>
+
+#include <initializer_list>
+
+// framing shared by CmdHelperBackend and cmd-helper: quint32 payload size (big
+// endian), quint8 type, then the QDataStream encoded payload
+
+namespace CmdHelperProtocol {
+
+enum Type : quint8 {
+    // client to helper
+    Start = 1,   // QByteArray session token, QString program, QStringList arguments
+    Write = 2,   // QByteArray stdin data
+    Signal = 3,  // qint32 signal number
+    // helper to client
+    Started = 10,       // qint64 pid
+    Output = 11,        // QByteArray
+    Error = 12,         // QByteArray
+    Finished = 13,      // qint32 exit code, qint32 exit status
+    FailedToStart = 14  // no payload, also the reply to a wrong session token
+};
+
+// one helper per client process, it only accepts the token the client passed to it
+// on stdin when starting it, so other processes of the same user can't use it
+inline QString socketPath(uint uid, qint64 client_pid)
+{
+    return QString("/run/libcmd/helper-%1-%2.sock").arg(uid).arg(client_pid);
+}
+
+inline QByteArray frame(Type type, const QByteArray &payload = QByteArray())
+{
+    QByteArray data(5, 0);
+    qToBigEndian(quint32(payload.size()), reinterpret_cast<uchar *>(data.data()));
+    data[4] = char(type);
+    return data + payload;
+}
+
+// remove the first complete frame from buffer, false if more data is needed
+inline bool takeFrame(QByteArray &buffer, quint8 &type, QByteArray &payload)
+{
+    if (buffer.size() < 5) {
+        return false;
+    }
+    const quint32 size = qFromBigEndian<quint32>(reinterpret_cast<const uchar *>(buffer.constData()));
+    if (quint32(buffer.size() - 5) < size) {
+        return false;
+    }
+    type = quint8(buffer.at(4));
+    payload = buffer.mid(5, int(size));
+    buffer.remove(0, 5 + int(size));
+    return true;
+}
+
+template <typename... Args>
+inline QByteArray encode(const Args &... args)
+{
+    QByteArray payload;
+    QDataStream stream(&payload, QIODevice::WriteOnly);
+    stream.setVersion(QDataStream::Qt_5_0);
+    (void)std::initializer_list<int>{ (stream << args, 0)... };
+    return payload;
+}
+
+} // namespace CmdHelperProtocol
+
+#endif // CMDHELPERPROTOCOL_H
@@ -0,0 +1,60 @@
+/**********************************************************************
+ *  cmdlinefilter.cpp
+ **********************************************************************
+ * Copyright (C) 2017 MX Authors
+ *
+ * Authors: Adrian
+ *          MX Linux <http://forum.mxlinux.org>
+ *
+ * This is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package. If not, see <http://www.gnu.org/licenses/>.
+ **********************************************************************/
+
+#include "cmdlinefilter.h"
+
+bool CmdLineFilter::isEmpty() const
+{
+    return prefixes.isEmpty() && substrings.isEmpty() && pattern.pattern().isEmpty();
+}
+
+bool CmdLineFilter::matches(const QString &line) const
+{
+    if (isEmpty()) {
+        return true;
+    }
+    for (const QString &prefix : prefixes) {
+        if (line.startsWith(prefix)) return true;
+    }
+    for (const QString &substring : substrings) {
+        if (line.contains(substring)) return true;
+    }
+    return !pattern.pattern().isEmpty() && pattern.match(line).hasMatch();
+}
+
+QString CmdLineFilter::filter(const QString &chunk, CmdLineSplitter *splitter) const
+{
+    QString kept;
+    splitter->split(chunk, [this, &kept](const QString &line) {
+        if (matches(line)) {
+            kept += line;
+            kept += '\n';
+        }
+    });
+    return kept;
+}
+
+QString CmdLineFilter::flush(CmdLineSplitter *splitter) const
+{
+    const QString line = splitter->takePartial();
+    return (!line.isEmpty() && matches(line)) ? line : QString();
+}
@@ -0,0 +1,50 @@
+/**********************************************************************
+ *  cmdlinefilter.h
+ **********************************************************************
+ * Copyright (C) 2017 MX Authors
+ *
+ * Authors: Adrian
+ *          MX Linux <http://forum.mxlinux.org>
+ *
+ * This is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package. If not, see <http://www.gnu.org/licenses/>.
+ **********************************************************************/
+
+
+#ifndef CMDLINEFILTER_H
+#define CMDLINEFILTER_H
+
+#include <QRegularExpression>
+#include <QStringList>
+
+#include "cmd_global.h"
+#include "cmdlinesplitter.h"
+
+// lines to keep from a run's output, applied while capturing so the rest is never
+// stored; a line is kept if it matches any of the criteria
+struct CMDSHARED_EXPORT CmdLineFilter
+{
+    QStringList prefixes;       // lines starting with one of these
+    QStringList substrings;     // lines containing one of these
+    QRegularExpression pattern; // lines matching, empty for none
+    bool drop_rejected = false; // also keep rejected lines out of outputAvailable()/errorAvailable()
+
+    bool isEmpty() const; // no criteria, every line is kept
+    bool matches(const QString &line) const;
+
+    // kept lines of chunk, the unterminated tail waits in the splitter for the next chunk
+    QString filter(const QString &chunk, CmdLineSplitter *splitter) const;
+    QString flush(CmdLineSplitter *splitter) const; // the tail once the output ended
+};
+
+#endif // CMDLINEFILTER_H
@@ -0,0 +1,80 @@
+/**********************************************************************
+ *  cmdlineindex.cpp
+ **********************************************************************
+ * Copyright (C) 2017 MX Authors
+ *
+ * Authors: Adrian
+ *          MX Linux <http://forum.mxlinux.org>
+ *
+ * This is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package. If not, see <http://www.gnu.org/licenses/>.
+ **********************************************************************/
+
+#include "cmdlineindex.h"
+
+CmdLineIndex::CmdLineIndex()
+{
+    starts.append(0);
+}
+
+int CmdLineIndex::lineCount() const
+{
+    return starts.last() == length ? starts.size() - 1 : starts.size();
+}
+
+int CmdLineIndex::lineLength(int n) const
+{
+    if (n < 0 || n >= lineCount()) {
+        return -1;
+    }
+    return (n + 1 < starts.size() ? starts.at(n + 1) - 1 : length) - starts.at(n);
+}
+
+int CmdLineIndex::lineStart(int n) const
+{
+    return (n < 0 || n >= lineCount()) ? -1 : starts.at(n);
+}
+
+void CmdLineIndex::append(const QString &chunk)
+{
+    const QChar *data = chunk.constData();
+    for (int i = 0; i < chunk.size(); ++i) {
+        if (data[i] == '\n') {
+            starts.append(length + i + 1);
+        }
+    }
+    length += chunk.size();
+}
+
+void CmdLineIndex::clear()
+{
+    length = 0;
+    starts.resize(1);
+    starts.squeeze();
+}
+
+QString CmdLineIndex::line(const QString &text, int n) const
+{
+    const int start = lineStart(n);
+    return start < 0 ? QString() : text.mid(start, lineLength(n));
+}
+
+QStringList CmdLineIndex::lines(const QString &text, int first, int count) const
+{
+    QStringList list;
+    const int last = qMin(first + count, lineCount());
+    for (int n = qMax(0, first); n < last; ++n) {
+        list << text.mid(starts.at(n), lineLength(n));
+    }
+    return list;
+}
@@ -0,0 +1,54 @@
+/**********************************************************************
+ *  cmdlineindex.h
+ **********************************************************************
+ * Copyright (C) 2017 MX Authors
+ *
+ * Authors: Adrian
+ *          MX Linux <http://forum.mxlinux.org>
+ *
+ * This is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package. If not, see <http://www.gnu.org/licenses/>.
+ **********************************************************************/
+
+
+#ifndef CMDLINEINDEX_H
+#define CMDLINEINDEX_H
+
+#include <QStringList>
+#include <QVector>
+
+#include "cmd_global.h"
+
+// offsets of the line starts in a string that is built by appending chunks, so a
+// line or a range of lines can be cut out without splitting the whole string
+class CMDSHARED_EXPORT CmdLineIndex
+{
+public:
+    CmdLineIndex();
+
+    int lineCount() const; // an unterminated last line counts
+    int lineLength(int n) const; // without the newline, -1 if out of range
+    int lineStart(int n) const;  // -1 if out of range
+    void append(const QString &chunk);
+    void clear();
+
+    // text is the string the chunks were appended to
+    QString line(const QString &text, int n) const;
+    QStringList lines(const QString &text, int first, int count) const;
+
+private:
+    int length = 0;
+    QVector<int> starts;
+};
+
+#endif // CMDLINEINDEX_H
@@ -0,0 +1,45 @@
+/**********************************************************************
+ *  cmdlinesplitter.cpp
+ **********************************************************************
+ * Copyright (C) 2017 MX Authors
+ *
+ * Authors: Adrian
+ *          MX Linux <http://forum.mxlinux.org>
+ *
+ * This is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package. If not, see <http://www.gnu.org/licenses/>.
+ **********************************************************************/
+
+#include "cmdlinesplitter.h"
+
+bool CmdLineSplitter::hasPartial() const
+{
+    return !rest.isEmpty();
+}
+
+QString CmdLineSplitter::partial() const
+{
+    return rest;
+}
+
+QString CmdLineSplitter::takePartial()
+{
+    QString line;
+    line.swap(rest);
+    return line;
+}
+
+void CmdLineSplitter::clear()
+{
+    rest.clear();
+}
@@ -0,0 +1,62 @@
+/**********************************************************************
+ *  cmdlinesplitter.h
+ **********************************************************************
+ * Copyright (C) 2017 MX Authors
+ *
+ * Authors: Adrian
+ *          MX Linux <http://forum.mxlinux.org>
+ *
+ * This is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package. If not, see <http://www.gnu.org/licenses/>.
+ **********************************************************************/
+
+
+#ifndef CMDLINESPLITTER_H
+#define CMDLINESPLITTER_H
+
+#include <QString>
+
+#include "cmd_global.h"
+
+// cuts text arriving in chunks into lines: split() hands each complete line to a
+// callback (without its newline) and keeps the unterminated tail for the next chunk
+class CMDSHARED_EXPORT CmdLineSplitter
+{
+public:
+    bool hasPartial() const;
+    QString partial() const;
+    QString takePartial(); // the tail once the input ended
+    void clear();
+
+    template <typename Callback>
+    void split(const QString &chunk, Callback onLine)
+    {
+        int start = 0;
+        int end;
+        while ((end = chunk.indexOf('\n', start)) >= 0) {
+            if (rest.isEmpty()) {
+                onLine(chunk.mid(start, end - start));
+            } else {
+                rest.append(chunk.midRef(start, end - start));
+                onLine(takePartial());
+            }
+            start = end + 1;
+        }
+        rest.append(chunk.midRef(start));
+    }
+
+private:
+    QString rest;
+};
+
+#endif // CMDLINESPLITTER_H
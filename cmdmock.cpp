@@ -0,0 +1,247 @@
+/**********************************************************************
+ *  cmdmock.cpp
+ **********************************************************************
+ * Copyright (C) 2017 MX Authors
+ *
+ * Authors: Adrian
+ *          MX Linux <http://forum.mxlinux.org>
+ *
+ * This is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package. If not, see <http://www.gnu.org/licenses/>.
+ **********************************************************************/
+
+#include <QEventLoop>
+
+#include "cmdmock.h"
+
+CmdMockBackend::CmdMockBackend(QObject *parent) :
+    CmdBackend(parent)
+{
+    timer = new QTimer(this);
+    timer->setSingleShot(true);
+    connect(timer, &QTimer::timeout, this, &CmdMockBackend::nextStep);
+}
+
+bool CmdMockBackend::pause()
+{
+    if (proc_state != QProcess::Running) {
+        return false;
+    }
+    timer->stop();
+    return true;
+}
+
+// resume restarts the interrupted step with its full delay
+bool CmdMockBackend::resume()
+{
+    if (proc_state != QProcess::Running) {
+        return false;
+    }
+    timer->start();
+    return true;
+}
+
+bool CmdMockBackend::waitForFinished(int msecs)
+{
+    if (proc_state == QProcess::NotRunning) {
+        return false;
+    }
+    QEventLoop loop;
+    connect(this, &CmdBackend::finished, &loop, &QEventLoop::quit);
+    if (msecs >= 0) {
+        QTimer::singleShot(msecs, &loop, &QEventLoop::quit);
+    }
+    loop.exec();
+    return (proc_state == QProcess::NotRunning);
+}
+
+bool CmdMockBackend::waitForStarted(int)
+{
+    return (proc_state == QProcess::Running);
+}
+
+int CmdMockBackend::exitCode() const
+{
+    return exit_code;
+}
+
+// no real process behind it, a pid would only point kill/pause at an unrelated process
+qint64 CmdMockBackend::processId() const
+{
+    return 0;
+}
+
+qint64 CmdMockBackend::write(const QByteArray &data)
+{
+    input += data;
+    return data.size();
+}
+
+void CmdMockBackend::kill()
+{
+    if (proc_state != QProcess::NotRunning) {
+        finish(9, QProcess::CrashExit);
+    }
+}
+
+// scripts are looked up by the command string Cmd records: the bash -c argument for
+// run(), the whole argument vector joined with spaces for exec()
+void CmdMockBackend::start(const QString &program, const QStringList &arguments)
+{
+    if (proc_state != QProcess::NotRunning) {
+        return;
+    }
+    args = arguments;
+    const bool shell = (program == "/bin/bash" && arguments.size() == 2 && arguments.first() == "-c");
+    script = scriptFor(shell ? arguments.last() : (QStringList(program) + arguments).join(' '));
+    ++run_count;
+    step = 0;
+    exit_code = 0;
+    exit_status = QProcess::NormalExit;
+    buffer_out.clear();
+    buffer_err.clear();
+    input.clear();
+    proc_state = QProcess::Running;
+    schedule(script.steps.isEmpty() ? script.exit_delay : script.steps.first().delay);
+}
+
+void CmdMockBackend::terminate()
+{
+    if (proc_state != QProcess::NotRunning) {
+        finish(15, QProcess::CrashExit);
+    }
+}
+
+QByteArray CmdMockBackend::readAllStandardError()
+{
+    QByteArray data;
+    data.swap(buffer_err);
+    return data;
+}
+
+QByteArray CmdMockBackend::readAllStandardOutput()
+{
+    QByteArray data;
+    data.swap(buffer_out);
+    return data;
+}
+
+QProcess::ExitStatus CmdMockBackend::exitStatus() const
+{
+    return exit_status;
+}
+
+QProcess::ProcessState CmdMockBackend::state() const
+{
+    return proc_state;
+}
+
+QStringList CmdMockBackend::arguments() const
+{
+    return args;
+}
+
+void CmdMockBackend::addScript(const QString &pattern, const CmdMockScript &script)
+{
+    scripts << qMakePair(QRegularExpression(pattern), script);
+}
+
+void CmdMockBackend::clearScripts()
+{
+    scripts.clear();
+}
+
+void CmdMockBackend::setDefaultScript(const CmdMockScript &script)
+{
+    default_script = script;
+}
+
+void CmdMockBackend::setSpeed(double factor)
+{
+    speed = qMax(0.0, factor);
+}
+
+// data written to the "process" through Cmd::writeToProc during the last run
+QByteArray CmdMockBackend::getInput() const
+{
+    return input;
+}
+
+int CmdMockBackend::getRunCount() const
+{
+    return run_count;
+}
+
+CmdMockScript CmdMockBackend::generate(const QByteArray &line, int count, int lines_per_sec, int exit_code)
+{
+    CmdMockScript script;
+    script.exit_code = exit_code;
+    if (count <= 0) {
+        return script;
+    }
+    // group lines in 10 ms chunks, the rate a real pipe would deliver them at
+    const int per_chunk = (lines_per_sec <= 0) ? count : qMax(1, lines_per_sec / 100);
+    const int delay = (lines_per_sec <= 0) ? 0 : per_chunk * 1000 / lines_per_sec;
+    for (int done = 0; done < count; done += per_chunk) {
+        CmdMockStep step;
+        step.delay = delay;
+        step.out = (line + '\n').repeated(qMin(per_chunk, count - done));
+        script.steps << step;
+    }
+    return script;
+}
+
+// first script whose pattern matches the command string, or the default one
+CmdMockScript CmdMockBackend::scriptFor(const QString &cmd_str)
+{
+    for (const auto &entry : scripts) {
+        if (entry.first.match(cmd_str).hasMatch()) {
+            return entry.second;
+        }
+    }
+    return default_script;
+}
+
+void CmdMockBackend::nextStep()
+{
+    if (step >= script.steps.size()) {
+        finish(script.exit_code, script.exit_status);
+        return;
+    }
+    const CmdMockStep &current = script.steps.at(step++);
+    if (!current.out.isEmpty()) {
+        buffer_out += current.out;
+        emit readyReadStandardOutput();
+    }
+    if (!current.err.isEmpty()) {
+        buffer_err += current.err;
+        emit readyReadStandardError();
+    }
+    if (proc_state == QProcess::Running) { // a slot could have killed it meanwhile
+        schedule(step < script.steps.size() ? script.steps.at(step).delay : script.exit_delay);
+    }
+}
+
+void CmdMockBackend::finish(int exit_code, QProcess::ExitStatus exit_status)
+{
+    timer->stop();
+    this->exit_code = exit_code;
+    this->exit_status = exit_status;
+    proc_state = QProcess::NotRunning;
+    emit finished(exit_code, exit_status);
+}
+
+void CmdMockBackend::schedule(int delay)
+{
+    timer->start(qRound(delay * speed));
+}
@@ -0,0 +1,115 @@
+/**********************************************************************
+ *  cmdmock.h
+ **********************************************************************
+ * Copyright (C) 2017 MX Authors
+ *
+ * Authors: Adrian
+ *          MX Linux <http://forum.mxlinux.org>
+ *
+ * This is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package. If not, see <http://www.gnu.org/licenses/>.
+ **********************************************************************/
+
+
+#ifndef CMDMOCK_H
+#define CMDMOCK_H
+
+#include <QList>
+#include <QPair>
+#include <QRegularExpression>
+#include <QTimer>
+
+#include "cmdbackend.h"
+
+// one chunk of scripted output, emitted after "delay" ms
+struct CmdMockStep
+{
+    int delay;
+    QByteArray out;
+    QByteArray err;
+};
+
+// scripted command: output steps, then exit after "exit_delay" ms
+struct CmdMockScript
+{
+    QList<CmdMockStep> steps;
+    int exit_code = 0;
+    int exit_delay = 0;
+    QProcess::ExitStatus exit_status = QProcess::NormalExit;
+};
+
+// backend that replays scripted output, exit codes and delays without spawning anything
+class CMDSHARED_EXPORT CmdMockBackend: public CmdBackend
+{
+    Q_OBJECT
+public:
+    explicit CmdMockBackend(QObject *parent = 0);
+
+    bool pause();
+    bool resume();
+    bool waitForFinished(int msecs = 30000);
+    bool waitForStarted(int msecs = 30000);
+    int exitCode() const;
+    qint64 processId() const;
+    qint64 write(const QByteArray &data);
+    void kill();
+    void start(const QString &program, const QStringList &arguments);
+    void terminate();
+
+    QByteArray readAllStandardError();
+    QByteArray readAllStandardOutput();
+    QProcess::ExitStatus exitStatus() const;
+    QProcess::ProcessState state() const;
+    QStringList arguments() const;
+
+    // scripts are matched against the command string in the order they were added
+    void addScript(const QString &pattern, const CmdMockScript &script);
+    void clearScripts();
+    void setDefaultScript(const CmdMockScript &script);
+
+    // multiply all scripted delays by factor, 0 replays as fast as the event loop allows
+    void setSpeed(double factor);
+
+    QByteArray getInput() const;
+    int getRunCount() const;
+
+    // script that produces "count" copies of line at lines_per_sec
+    static CmdMockScript generate(const QByteArray &line, int count, int lines_per_sec, int exit_code = 0);
+
+protected:
+    virtual CmdMockScript scriptFor(const QString &cmd_str);
+
+private slots:
+    void nextStep();
+
+private:
+    double speed = 1.0;
+    int exit_code = 0;
+    int run_count = 0;
+    int step = 0;
+    QByteArray buffer_out, buffer_err;
+    QByteArray input;
+    QList<QPair<QRegularExpression, CmdMockScript>> scripts;
+    QProcess::ExitStatus exit_status = QProcess::NormalExit;
+    QProcess::ProcessState proc_state = QProcess::NotRunning;
+    QStringList args;
+    QTimer *timer;
+    CmdMockScript default_script;
+    CmdMockScript script;
+
+    void finish(int exit_code, QProcess::ExitStatus exit_status);
+    void schedule(int delay);
+
+};
+
+#endif // CMDMOCK_H
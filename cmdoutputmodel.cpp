@@ -0,0 +1,176 @@
+/**********************************************************************
+ *  cmdoutputmodel.cpp
+ **********************************************************************
+ * Copyright (C) 2017 MX Authors
+ *
+ * Authors: Adrian
+ *          MX Linux <http://forum.mxlinux.org>
+ *
+ * This is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package. If not, see <http://www.gnu.org/licenses/>.
+ **********************************************************************/
+
+#include "cmdoutputmodel.h"
+
+CmdOutputModel::CmdOutputModel(QObject *parent) :
+    QAbstractTableModel(parent)
+{
+    batch_timer.setSingleShot(true);
+    batch_timer.setInterval(50);
+    connect(&batch_timer, &QTimer::timeout, this, &CmdOutputModel::flush);
+}
+
+void CmdOutputModel::setSource(Cmd *cmd)
+{
+    if (source) {
+        source->disconnect(this);
+    }
+    source = cmd;
+    if (cmd) {
+        connect(cmd, &Cmd::outputAvailable, this, &CmdOutputModel::addOutput);
+        connect(cmd, &Cmd::finished, this, &CmdOutputModel::onFinished);
+    }
+}
+
+Cmd *CmdOutputModel::getSource() const
+{
+    return source;
+}
+
+void CmdOutputModel::setSeparator(const QRegularExpression &separator)
+{
+    this->separator = separator;
+}
+
+void CmdOutputModel::setParser(const Parser &parser)
+{
+    this->parser = parser;
+}
+
+void CmdOutputModel::setHeaders(const QStringList &headers)
+{
+    this->headers = headers;
+    if (headers.size() > columns) {
+        beginInsertColumns(QModelIndex(), columns, headers.size() - 1);
+        columns = headers.size();
+        endInsertColumns();
+    }
+    emit headerDataChanged(Qt::Horizontal, 0, columns - 1);
+}
+
+void CmdOutputModel::setBatchInterval(int msecs)
+{
+    batch_timer.setInterval(qMax(0, msecs));
+}
+
+void CmdOutputModel::clear()
+{
+    beginResetModel();
+    batch_timer.stop();
+    columns = headers.size();
+    splitter.clear();
+    rows.clear();
+    pending.clear();
+    endResetModel();
+}
+
+QStringList CmdOutputModel::row(int n) const
+{
+    return rows.value(n);
+}
+
+int CmdOutputModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : columns;
+}
+
+int CmdOutputModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : rows.size();
+}
+
+QVariant CmdOutputModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= rows.size() || (role != Qt::DisplayRole && role != Qt::EditRole)) {
+        return QVariant();
+    }
+    return rows.at(index.row()).value(index.column());
+}
+
+QVariant CmdOutputModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation == Qt::Horizontal && role == Qt::DisplayRole && section < headers.size()) {
+        return headers.at(section);
+    }
+    return QAbstractTableModel::headerData(section, orientation, role);
+}
+
+// one beginInsertRows() block for everything parsed since the last flush, widening
+// the table first if a row has more columns than seen so far
+void CmdOutputModel::flush()
+{
+    batch_timer.stop();
+    if (pending.isEmpty()) {
+        return;
+    }
+    int width = columns;
+    for (const QStringList &fields : pending) {
+        width = qMax(width, fields.size());
+    }
+    if (width > columns) {
+        beginInsertColumns(QModelIndex(), columns, width - 1);
+        columns = width;
+        endInsertColumns();
+    }
+    beginInsertRows(QModelIndex(), rows.size(), rows.size() + pending.size() - 1);
+    rows += pending;
+    pending.clear();
+    endInsertRows();
+}
+
+void CmdOutputModel::addOutput(const QString &output)
+{
+    splitter.split(output, [this](const QString &line) { addLine(line); });
+    if (!pending.isEmpty() && !batch_timer.isActive()) {
+        batch_timer.start();
+    }
+}
+
+void CmdOutputModel::onFinished()
+{
+    if (splitter.hasPartial()) {
+        addLine(splitter.takePartial());
+    }
+    flush();
+}
+
+void CmdOutputModel::addLine(const QString &line)
+{
+    QStringList fields;
+    if (parser) {
+        fields = parser(line);
+    } else if (line.isEmpty()) {
+        return;
+    } else if (separator.pattern().isEmpty()) {
+        fields << line;
+    } else {
+#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
+        fields = line.split(separator, Qt::SkipEmptyParts);
+#else
+        fields = line.split(separator, QString::SkipEmptyParts);
+#endif
+    }
+    if (!fields.isEmpty()) {
+        pending.append(fields);
+    }
+}
@@ -0,0 +1,85 @@
+/**********************************************************************
+ *  cmdoutputmodel.h
+ **********************************************************************
+ * Copyright (C) 2017 MX Authors
+ *
+ * Authors: Adrian
+ *          MX Linux <http://forum.mxlinux.org>
+ *
+ * This is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package. If not, see <http://www.gnu.org/licenses/>.
+ **********************************************************************/
+
+
+#ifndef CMDOUTPUTMODEL_H
+#define CMDOUTPUTMODEL_H
+
+#include <QAbstractTableModel>
+#include <QPointer>
+#include <QRegularExpression>
+#include <QTimer>
+#include <QVector>
+
+#include <functional>
+
+#include "cmd.h"
+
+// table model filled from a Cmd's output while it runs: lines are parsed into rows
+// and inserted in batches, so views populate progressively; run the Cmd with the
+// "discard" option to keep the rows only here and not also as captured output
+class CMDSHARED_EXPORT CmdOutputModel: public QAbstractTableModel
+{
+    Q_OBJECT
+public:
+    using Parser = std::function<QStringList(const QString &line)>; // empty list skips the line
+
+    explicit CmdOutputModel(QObject *parent = 0);
+
+    void setSource(Cmd *cmd); // not owned, nullptr to detach
+    Cmd *getSource() const;
+
+    // split lines into columns, empty regex for one column with the whole line
+    void setSeparator(const QRegularExpression &separator);
+    void setParser(const Parser &parser); // takes precedence over the separator
+    void setHeaders(const QStringList &headers);
+    void setBatchInterval(int msecs); // rows are inserted at most this often
+    void clear();
+
+    QStringList row(int n) const;
+
+    int columnCount(const QModelIndex &parent = QModelIndex()) const;
+    int rowCount(const QModelIndex &parent = QModelIndex()) const;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const;
+
+public slots:
+    void flush(); // insert the pending rows now
+
+private slots:
+    void addOutput(const QString &output);
+    void onFinished();
+
+private:
+    int columns = 0;
+    Parser parser;
+    QPointer<Cmd> source;
+    QRegularExpression separator;
+    CmdLineSplitter splitter; // holds the last line until its newline arrives
+    QStringList headers;
+    QTimer batch_timer;
+    QVector<QStringList> rows, pending;
+
+    void addLine(const QString &line);
+};
+
+#endif // CMDOUTPUTMODEL_H
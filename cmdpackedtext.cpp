@@ -0,0 +1,87 @@
+/**********************************************************************
+ *  cmdpackedtext.cpp
+ **********************************************************************
+ * Copyright (C) 2017 MX Authors
+ *
+ * Authors: Adrian
+ *          MX Linux <http://forum.mxlinux.org>
+ *
+ * This is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package. If not, see <http://www.gnu.org/licenses/>.
+ **********************************************************************/
+
+#include "cmdpackedtext.h"
+
+#include <algorithm>
+
+bool CmdPackedText::isEmpty() const
+{
+    return blocks.isEmpty();
+}
+
+int CmdPackedText::lineCount() const
+{
+    return lines;
+}
+
+QString CmdPackedText::line(int n) const
+{
+    if (n < 0 || n >= lines) {
+        return QString();
+    }
+    const int block = int(std::upper_bound(first_lines.cbegin(), first_lines.cend(), n) - first_lines.cbegin()) - 1;
+    if (block != cached_block) {
+        cached_text = QString::fromUtf8(qUncompress(blocks.at(block)));
+        cached_index.clear();
+        cached_index.append(cached_text);
+        cached_block = block;
+    }
+    return cached_index.line(cached_text, n - first_lines.at(block));
+}
+
+QString CmdPackedText::unpack() const
+{
+    QString text;
+    for (const QByteArray &block : blocks) {
+        text += QString::fromUtf8(qUncompress(block));
+    }
+    return text;
+}
+
+void CmdPackedText::clear()
+{
+    lines = 0;
+    blocks.clear();
+    first_lines.clear();
+    cached_block = -1;
+    cached_index.clear();
+    cached_text.clear();
+}
+
+// blocks of about block_size characters, each extended to the end of its line so a
+// line never spans two blocks
+void CmdPackedText::pack(const QString &text, int block_size)
+{
+    clear();
+    block_size = qMax(1, block_size);
+    int start = 0;
+    while (start < text.size()) {
+        int end = text.indexOf('\n', qMin(start + block_size, text.size()) - 1);
+        end = (end < 0) ? text.size() : end + 1;
+        const QString block = text.mid(start, end - start);
+        first_lines.append(lines);
+        lines += block.count('\n') + (block.endsWith('\n') ? 0 : 1);
+        blocks.append(qCompress(block.toUtf8()));
+        start = end;
+    }
+}
@@ -0,0 +1,58 @@
+/**********************************************************************
+ *  cmdpackedtext.h
+ **********************************************************************
+ * Copyright (C) 2017 MX Authors
+ *
+ * Authors: Adrian
+ *          MX Linux <http://forum.mxlinux.org>
+ *
+ * This is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package. If not, see <http://www.gnu.org/licenses/>.
+ **********************************************************************/
+
+
+#ifndef CMDPACKEDTEXT_H
+#define CMDPACKEDTEXT_H
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+
+#include "cmd_global.h"
+#include "cmdlineindex.h"
+
+// text kept as zlib compressed, line aligned blocks: unpack() restores all of it, a
+// line lookup only unpacks the block holding the line (the last one is cached)
+class CMDSHARED_EXPORT CmdPackedText
+{
+public:
+    enum { DefaultBlockSize = 1 << 20 }; // characters per block before compression
+
+    bool isEmpty() const;
+    int lineCount() const; // an unterminated last line counts
+    QString line(int n) const; // without the newline
+    QString unpack() const;
+    void clear();
+    void pack(const QString &text, int block_size = DefaultBlockSize);
+
+private:
+    int lines = 0;
+    QVector<QByteArray> blocks;
+    QVector<int> first_lines; // number of the first line in each block
+
+    mutable int cached_block = -1;
+    mutable CmdLineIndex cached_index;
+    mutable QString cached_text;
+};
+
+#endif // CMDPACKEDTEXT_H
@@ -0,0 +1,117 @@
+/**********************************************************************
+ *  cmdparallel.cpp
+ **********************************************************************
+ * Copyright (C) 2017 MX Authors
+ *
+ * Authors: Adrian
+ *          MX Linux <http://forum.mxlinux.org>
+ *
+ * This is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package. If not, see <http://www.gnu.org/licenses/>.
+ **********************************************************************/
+
+#include "cmdparallel.h"
+
+#include <QtConcurrent>
+
+CmdParallelParser::CmdParallelParser(const Parser &parser, int chunk_size, QObject *parent) :
+    QObject(parent),
+    chunk_size(qMax(1, chunk_size)),
+    parser(parser)
+{
+}
+
+void CmdParallelParser::setSource(Cmd *cmd)
+{
+    if (source) {
+        source->disconnect(this);
+    }
+    source = cmd;
+    if (cmd) {
+        connect(cmd, &Cmd::outputAvailable, this, &CmdParallelParser::addOutput);
+        connect(cmd, &Cmd::finished, this, &CmdParallelParser::finish);
+    }
+}
+
+QVariantList CmdParallelParser::results()
+{
+    finish();
+    QVariantList list;
+    list.reserve(futures.size());
+    for (const QFuture<QVariant> &future : futures) {
+        list << future.result();
+    }
+    return list;
+}
+
+void CmdParallelParser::clear()
+{
+    for (QFuture<QVariant> &future : futures) {
+        future.waitForFinished();
+    }
+    futures.clear();
+    pending.clear();
+}
+
+QVariantList CmdParallelParser::map(const QString &text, const Parser &parser, int chunk_size)
+{
+    CmdParallelParser parallel(parser, chunk_size);
+    for (const QString &chunk : split(text, chunk_size)) {
+        parallel.queue(chunk);
+    }
+    return parallel.results();
+}
+
+// chunks of about chunk_size characters, each extended to the end of its line
+QStringList CmdParallelParser::split(const QString &text, int chunk_size)
+{
+    QStringList chunks;
+    chunk_size = qMax(1, chunk_size);
+    int start = 0;
+    while (start < text.size()) {
+        int end = text.indexOf('\n', qMin(start + chunk_size, text.size()) - 1);
+        end = (end < 0) ? text.size() : end + 1;
+        chunks << text.mid(start, end - start);
+        start = end;
+    }
+    return chunks;
+}
+
+// hand out whole lines once a chunk worth of text arrived
+void CmdParallelParser::addOutput(const QString &output)
+{
+    pending += output;
+    if (pending.size() < chunk_size) {
+        return;
+    }
+    const int end = pending.lastIndexOf('\n') + 1;
+    if (end == 0) {
+        return;
+    }
+    queue(pending.left(end));
+    pending.remove(0, end);
+}
+
+void CmdParallelParser::finish()
+{
+    if (!pending.isEmpty()) {
+        queue(pending);
+        pending.clear();
+    }
+}
+
+void CmdParallelParser::queue(const QString &chunk)
+{
+    const Parser parser = this->parser;
+    futures << QtConcurrent::run([parser, chunk]() { return parser(chunk); });
+}
@@ -0,0 +1,68 @@
+/**********************************************************************
+ *  cmdparallel.h
+ **********************************************************************
+ * Copyright (C) 2017 MX Authors
+ *
+ * Authors: Adrian
+ *          MX Linux <http://forum.mxlinux.org>
+ *
+ * This is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package. If not, see <http://www.gnu.org/licenses/>.
+ **********************************************************************/
+
+
+#ifndef CMDPARALLEL_H
+#define CMDPARALLEL_H
+
+#include <QFuture>
+#include <QPointer>
+#include <QVariant>
+
+#include <functional>
+
+#include "cmd.h"
+
+// runs a parser over output split at line boundaries into chunks on the global
+// thread pool, results come back in output order; fed from a Cmd the chunks are
+// parsed while the command is still running
+class CMDSHARED_EXPORT CmdParallelParser: public QObject
+{
+    Q_OBJECT
+public:
+    using Parser = std::function<QVariant(const QString &chunk)>; // chunk of whole lines, called from pool threads
+    enum { DefaultChunkSize = 1 << 20 }; // characters
+
+    explicit CmdParallelParser(const Parser &parser, int chunk_size = DefaultChunkSize, QObject *parent = 0);
+
+    void setSource(Cmd *cmd); // not owned, nullptr to detach
+    QVariantList results();   // waits for the parsers, queues any text not handed out yet
+    void clear();
+
+    static QVariantList map(const QString &text, const Parser &parser, int chunk_size = DefaultChunkSize);
+    static QStringList split(const QString &text, int chunk_size = DefaultChunkSize);
+
+public slots:
+    void addOutput(const QString &output);
+    void finish(); // the output is complete, queue the rest
+
+private:
+    int chunk_size;
+    Parser parser;
+    QList<QFuture<QVariant>> futures;
+    QPointer<Cmd> source;
+    QString pending; // text not handed out yet
+
+    void queue(const QString &chunk);
+};
+
+#endif // CMDPARALLEL_H
@@ -0,0 +1,167 @@
+/**********************************************************************
+ *  cmdpoller.cpp
+ **********************************************************************
+ * Copyright (C) 2017 MX Authors
+ *
+ * Authors: Adrian
+ *          MX Linux <http://forum.mxlinux.org>
+ *
+ * This is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package. If not, see <http://www.gnu.org/licenses/>.
+ **********************************************************************/
+
+#include "cmdpoller.h"
+
+CmdPoller::CmdPoller(QObject *parent) :
+    QObject(parent)
+{
+    clock.start();
+    timer = new QTimer(this);
+    timer->setSingleShot(true);
+    connect(timer, &QTimer::timeout, this, &CmdPoller::wake);
+}
+
+// register a command, it first runs on the next aligned wakeup
+int CmdPoller::add(const QString &cmd_str, int interval, const QStringList &options)
+{
+    const int id = next_id++;
+    Poll poll;
+    poll.interval = qMax(1, interval);
+    poll.current = poll.interval;
+    poll.due = clock.elapsed();
+    poll.cmd = new Cmd(this);
+    poll.cmd_str = cmd_str;
+    poll.options = options;
+    if (!poll.options.contains("xxhash")) {
+        poll.options << "xxhash"; // cheap change detection, hashed while capturing
+    }
+    connect(poll.cmd, &Cmd::finished, this, [this, id]() { onPollFinished(id); });
+    polls.insert(id, poll);
+    reschedule();
+    return id;
+}
+
+void CmdPoller::remove(int id)
+{
+    auto it = polls.find(id);
+    if (it == polls.end()) {
+        return;
+    }
+    Cmd *cmd = it.value().cmd;
+    polls.erase(it);
+    cmd->disconnect(this);
+    cmd->deleteLater(); // terminates a poll still running
+    reschedule();
+}
+
+// last output of the poll, empty until it ran once
+QString CmdPoller::getOutput(int id) const
+{
+    return polls.value(id).output;
+}
+
+void CmdPoller::setSuspended(bool suspended)
+{
+    this->suspended = suspended;
+    reschedule();
+}
+
+bool CmdPoller::isSuspended() const
+{
+    return suspended;
+}
+
+void CmdPoller::setGranularity(int msecs)
+{
+    granularity = qMax(1, msecs);
+    reschedule();
+}
+
+int CmdPoller::getGranularity() const
+{
+    return granularity;
+}
+
+void CmdPoller::setMaxBackoff(int factor)
+{
+    max_backoff = qMax(1, factor);
+}
+
+int CmdPoller::getMaxBackoff() const
+{
+    return max_backoff;
+}
+
+// run everything due by the end of this granularity slot, polls still running are skipped
+void CmdPoller::wake()
+{
+    if (suspended) {
+        return;
+    }
+    const qint64 now = clock.elapsed();
+    for (auto it = polls.begin(); it != polls.end(); ++it) {
+        Poll &poll = it.value();
+        if (poll.due <= now + granularity / 2 && !poll.cmd->isRunning()) {
+            poll.due = now + poll.current; // until it finishes and sets the real next time
+            poll.cmd->start(poll.cmd_str, poll.options);
+        }
+    }
+    reschedule();
+}
+
+void CmdPoller::onPollFinished(int id)
+{
+    auto it = polls.find(id);
+    if (it == polls.end()) {
+        return;
+    }
+    Poll &poll = it.value();
+    const quint64 hash = poll.cmd->getOutputHash();
+    const bool differs = (!poll.polled || hash != poll.hash);
+    if (differs) {
+        poll.polled = true;
+        poll.hash = hash;
+        poll.output = poll.cmd->getOutput();
+        poll.current = poll.interval;
+    } else {
+        poll.current = qMin(poll.current * 2, poll.interval * max_backoff);
+    }
+    poll.due = clock.elapsed() + poll.current;
+    const QString output = poll.output; // a slot may remove the poll
+    reschedule();
+    if (differs) {
+        emit changed(id, output);
+    }
+}
+
+// arm the timer for the earliest due poll, rounded up to the granularity grid
+void CmdPoller::reschedule()
+{
+    if (suspended || polls.isEmpty()) {
+        timer->stop();
+        return;
+    }
+    qint64 due = -1;
+    for (const Poll &poll : polls) {
+        if (!poll.cmd->isRunning() && (due < 0 || poll.due < due)) {
+            due = poll.due;
+        }
+    }
+    if (due < 0) {
+        timer->stop(); // all running, onPollFinished() reschedules
+        return;
+    }
+    const qint64 now = clock.elapsed();
+    const qint64 aligned = ((qMax(due, now) + granularity - 1) / granularity) * granularity;
+    timer->start(int(aligned - now));
+}
@@ -0,0 +1,90 @@
+/**********************************************************************
+ *  cmdpoller.h
+ **********************************************************************
+ * Copyright (C) 2017 MX Authors
+ *
+ * Authors: Adrian
+ *          MX Linux <http://forum.mxlinux.org>
+ *
+ * This is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package. If not, see <http://www.gnu.org/licenses/>.
+ **********************************************************************/
+
+
+#ifndef CMDPOLLER_H
+#define CMDPOLLER_H
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QTimer>
+
+#include "cmd.h"
+
+// runs registered commands periodically from one shared timer: wakeups are aligned
+// to a common granularity so polls run together, the interval backs off while the
+// output stays the same and changed() is only emitted when it differs
+class CMDSHARED_EXPORT CmdPoller: public QObject
+{
+    Q_OBJECT
+public:
+    explicit CmdPoller(QObject *parent = 0);
+
+    int add(const QString &cmd_str, int interval, const QStringList &options = QStringList("quiet")); // interval in ms
+    void remove(int id);
+
+    QString getOutput(int id) const;
+
+    // no polls run while suspended (e.g. window hidden), overdue ones run on resume
+    void setSuspended(bool suspended);
+    bool isSuspended() const;
+
+    void setGranularity(int msecs);
+    int getGranularity() const;
+
+    // unchanged output doubles the interval up to factor times the registered one
+    void setMaxBackoff(int factor);
+    int getMaxBackoff() const;
+
+signals:
+    void changed(int id, const QString &output);
+
+private slots:
+    void wake();
+
+private:
+    struct Poll
+    {
+        bool polled = false;
+        int current;  // interval after backoff
+        int interval; // registered interval
+        qint64 due;
+        quint64 hash = 0; // of the raw output
+        Cmd *cmd;
+        QString cmd_str;
+        QString output;
+        QStringList options;
+    };
+
+    bool suspended = false;
+    int granularity = 1000;
+    int max_backoff = 8;
+    int next_id = 1;
+    QElapsedTimer clock;
+    QHash<int, Poll> polls;
+    QTimer *timer;
+
+    void onPollFinished(int id);
+    void reschedule();
+};
+
+#endif // CMDPOLLER_H
@@ -0,0 +1,201 @@
+/**********************************************************************
+ *  cmdrecorder.cpp
+ **********************************************************************
+ * Copyright (C) 2017 MX Authors
+ *
+ * Authors: Adrian
+ *          MX Linux <http://forum.mxlinux.org>
+ *
+ * This is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package. If not, see <http://www.gnu.org/licenses/>.
+ **********************************************************************/
+
+#include <QDataStream>
+#include <QDebug>
+
+#include "cmdrecorder.h"
+
+static const quint32 record_magic = 0x434d4452; // "CMDR"
+static const quint32 record_version = 1;
+
+CmdRecorder::CmdRecorder(const QString &file_name)
+{
+    if (!file_name.isEmpty()) {
+        open(file_name);
+    }
+}
+
+CmdRecorder::~CmdRecorder()
+{
+    close();
+}
+
+bool CmdRecorder::isOpen() const
+{
+    return file.isOpen();
+}
+
+bool CmdRecorder::open(const QString &file_name)
+{
+    close();
+    file.setFileName(file_name);
+    if (!file.open(QFile::WriteOnly | QFile::Append)) {
+        qDebug() << "could not open recording file" << file_name;
+        return false;
+    }
+    if (file.size() == 0) {
+        QDataStream stream(&file);
+        stream << record_magic << record_version;
+    }
+    return true;
+}
+
+void CmdRecorder::close()
+{
+    recording = false;
+    if (file.isOpen()) {
+        file.close();
+    }
+}
+
+void CmdRecorder::addError(const QByteArray &data)
+{
+    addChunk(QByteArray(), data);
+}
+
+void CmdRecorder::addOutput(const QByteArray &data)
+{
+    addChunk(data, QByteArray());
+}
+
+void CmdRecorder::beginRun(const QString &cmd_str)
+{
+    if (!file.isOpen()) {
+        return;
+    }
+    session = Session();
+    session.command = cmd_str;
+    recording = true;
+    last_chunk.start();
+}
+
+// each session is written as one compressed block once the run is done
+void CmdRecorder::endRun(int exit_code, QProcess::ExitStatus exit_status)
+{
+    if (!recording) {
+        return;
+    }
+    recording = false;
+    session.script.exit_code = exit_code;
+    session.script.exit_status = exit_status;
+    session.script.exit_delay = int(last_chunk.elapsed());
+
+    QByteArray block;
+    QDataStream stream(&block, QIODevice::WriteOnly);
+    stream.setVersion(QDataStream::Qt_5_0);
+    stream << session.command << qint32(session.script.steps.size());
+    for (const CmdMockStep &step : session.script.steps) {
+        stream << qint32(step.delay) << step.out << step.err;
+    }
+    stream << qint32(exit_code) << qint32(exit_status) << qint32(session.script.exit_delay);
+
+    QDataStream out(&file);
+    out << qCompress(block);
+    file.flush();
+}
+
+QList<CmdRecorder::Session> CmdRecorder::load(const QString &file_name)
+{
+    QList<Session> sessions;
+    QFile file(file_name);
+    if (!file.open(QFile::ReadOnly)) {
+        qDebug() << "could not open recording file" << file_name;
+        return sessions;
+    }
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_0);
+    quint32 magic, version;
+    stream >> magic >> version;
+    if (magic != record_magic || version != record_version) {
+        qDebug() << "not a libcmd recording:" << file_name;
+        return sessions;
+    }
+    while (!stream.atEnd()) {
+        QByteArray compressed;
+        stream >> compressed;
+        if (stream.status() != QDataStream::Ok) {
+            break; // truncated file, keep what was read so far
+        }
+        QDataStream block(qUncompress(compressed));
+        block.setVersion(QDataStream::Qt_5_0);
+        Session session;
+        qint32 steps, exit_code, exit_status, exit_delay;
+        block >> session.command >> steps;
+        for (int i = 0; i < steps && block.status() == QDataStream::Ok; ++i) {
+            qint32 delay;
+            CmdMockStep step;
+            block >> delay >> step.out >> step.err;
+            step.delay = delay;
+            session.script.steps << step;
+        }
+        block >> exit_code >> exit_status >> exit_delay;
+        if (block.status() != QDataStream::Ok) {
+            continue;
+        }
+        session.script.exit_code = exit_code;
+        session.script.exit_status = static_cast<QProcess::ExitStatus>(exit_status);
+        session.script.exit_delay = exit_delay;
+        sessions << session;
+    }
+    return sessions;
+}
+
+void CmdRecorder::addChunk(const QByteArray &out, const QByteArray &err)
+{
+    if (!recording || (out.isEmpty() && err.isEmpty())) {
+        return;
+    }
+    CmdMockStep step;
+    step.delay = int(last_chunk.restart());
+    step.out = out;
+    step.err = err;
+    session.script.steps << step;
+}
+
+CmdReplayBackend::CmdReplayBackend(QObject *parent) :
+    CmdMockBackend(parent)
+{
+}
+
+bool CmdReplayBackend::load(const QString &file_name)
+{
+    const QList<CmdRecorder::Session> loaded = CmdRecorder::load(file_name);
+    for (const CmdRecorder::Session &session : loaded) {
+        sessions[session.command] << session.script;
+    }
+    return !loaded.isEmpty();
+}
+
+// serve the recorded runs of a command in order, wrapping around when exhausted;
+// commands never recorded fall back to the mock scripts
+CmdMockScript CmdReplayBackend::scriptFor(const QString &cmd_str)
+{
+    auto it = sessions.constFind(cmd_str);
+    if (it == sessions.constEnd() || it->isEmpty()) {
+        return CmdMockBackend::scriptFor(cmd_str);
+    }
+    int &index = next[cmd_str];
+    const CmdMockScript script = it->at(index);
+    index = (index + 1) % it->size();
+    return script;
+}
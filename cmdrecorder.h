@@ -0,0 +1,86 @@
+/**********************************************************************
+ *  cmdrecorder.h
+ **********************************************************************
+ * Copyright (C) 2017 MX Authors
+ *
+ * Authors: Adrian
+ *          MX Linux <http://forum.mxlinux.org>
+ *
+ * This is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package. If not, see <http://www.gnu.org/licenses/>.
+ **********************************************************************/
+
+
+#ifndef CMDRECORDER_H
+#define CMDRECORDER_H
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QHash>
+
+#include "cmd_global.h"
+#include "cmdmock.h"
+
+// records each run's command, output chunks with timing and exit status into a
+// compact file, and loads them back for CmdReplayBackend
+class CMDSHARED_EXPORT CmdRecorder
+{
+public:
+    struct Session
+    {
+        QString command;
+        CmdMockScript script;
+    };
+
+    explicit CmdRecorder(const QString &file_name = QString());
+    ~CmdRecorder();
+
+    bool isOpen() const;
+    bool open(const QString &file_name); // new sessions are appended to an existing file
+    void close();
+
+    void addError(const QByteArray &data);
+    void addOutput(const QByteArray &data);
+    void beginRun(const QString &cmd_str);
+    void endRun(int exit_code, QProcess::ExitStatus exit_status);
+
+    static QList<Session> load(const QString &file_name);
+
+private:
+    bool recording = false;
+    QElapsedTimer last_chunk;
+    QFile file;
+    Session session;
+
+    void addChunk(const QByteArray &out, const QByteArray &err);
+};
+
+// backend that replays recorded sessions, runs of the same command are served in
+// recorded order; use setSpeed() to replay faster (< 1) or slower (> 1)
+class CMDSHARED_EXPORT CmdReplayBackend: public CmdMockBackend
+{
+    Q_OBJECT
+public:
+    explicit CmdReplayBackend(QObject *parent = 0);
+
+    bool load(const QString &file_name);
+
+protected:
+    CmdMockScript scriptFor(const QString &cmd_str);
+
+private:
+    QHash<QString, QList<CmdMockScript>> sessions;
+    QHash<QString, int> next;
+};
+
+#endif // CMDRECORDER_H
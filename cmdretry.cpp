@@ -0,0 +1,78 @@
+/**********************************************************************
+ *  cmdretry.cpp
+ **********************************************************************
+ * Copyright (C) 2017 MX Authors
+ *
+ * Authors: Adrian
+ *          MX Linux <http://forum.mxlinux.org>
+ *
+ * This is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package. If not, see <http://www.gnu.org/licenses/>.
+ **********************************************************************/
+
+#include <QtGlobal>
+#if QT_VERSION >= QT_VERSION_CHECK(5, 10, 0)
+#include <QRandomGenerator>
+#endif
+
+#include <cmath>
+#include <random>
+
+#include "cmdretry.h"
+
+// attempt is the number of runs done so far
+bool CmdRetryPolicy::mayRetry(int attempt, int exit_code) const
+{
+    if (exit_code == 0 || attempt >= max_attempts) {
+        return false;
+    }
+    return (exit_codes.isEmpty() || exit_codes.contains(exit_code));
+}
+
+bool CmdRetryPolicy::shouldRetry(int attempt, int exit_code, const QString &output, const QString &error) const
+{
+    if (!mayRetry(attempt, exit_code)) {
+        return false;
+    }
+    if (!pattern.pattern().isEmpty()) {
+        return (pattern.match(error).hasMatch() || pattern.match(output).hasMatch());
+    }
+    return true;
+}
+
+// delay in ms before the run following "attempt", with exponential backoff and jitter
+int CmdRetryPolicy::delay(int attempt) const
+{
+    double value = initial_delay * std::pow(qMax(1.0, multiplier), qMax(0, attempt - 1));
+    value = qMin(value, double(max_delay));
+    if (jitter > 0) {
+        // seeded per process so clients contending for the same lock spread out
+#if QT_VERSION >= QT_VERSION_CHECK(5, 10, 0)
+        const double unit = QRandomGenerator::global()->generateDouble();
+#else
+        static thread_local std::mt19937 engine{std::random_device{}()};
+        const double unit = std::uniform_real_distribution<double>(0.0, 1.0)(engine);
+#endif
+        value *= 1.0 + jitter * (2.0 * unit - 1.0);
+    }
+    return qMax(0, qRound(value));
+}
+
+CmdRetryPolicy CmdRetryPolicy::dpkgLock(int max_attempts)
+{
+    CmdRetryPolicy policy;
+    policy.max_attempts = max_attempts;
+    policy.initial_delay = 2000;
+    policy.pattern = QRegularExpression("Could not get lock|Unable to acquire the dpkg frontend lock|dpkg status database is locked");
+    return policy;
+}
@@ -0,0 +1,52 @@
+/**********************************************************************
+ *  cmdretry.h
+ **********************************************************************
+ * Copyright (C) 2017 MX Authors
+ *
+ * Authors: Adrian
+ *          MX Linux <http://forum.mxlinux.org>
+ *
+ * This is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package. If not, see <http://www.gnu.org/licenses/>.
+ **********************************************************************/
+
+
+#ifndef CMDRETRY_H
+#define CMDRETRY_H
+
+#include <QList>
+#include <QRegularExpression>
+
+#include "cmd_global.h"
+
+// declarative retry: which failures to retry and how long to wait in between,
+// the wait is timer based so the event loop keeps running
+struct CMDSHARED_EXPORT CmdRetryPolicy
+{
+    int max_attempts = 1;       // including the first run, 1 disables retries
+    int initial_delay = 1000;   // ms before the second attempt
+    int max_delay = 30000;      // ms, cap for the exponential backoff
+    double multiplier = 2.0;
+    double jitter = 0.2;        // random +/- fraction of the delay
+    QList<int> exit_codes;      // retry only these exit codes, empty for any failure
+    QRegularExpression pattern; // retry only if output or error matches, empty for any
+
+    bool mayRetry(int attempt, int exit_code) const; // everything but the pattern, check before building output
+    bool shouldRetry(int attempt, int exit_code, const QString &output, const QString &error) const;
+    int delay(int attempt) const;
+
+    // apt/dpkg failing on "Could not get lock /var/lib/dpkg/lock..."
+    static CmdRetryPolicy dpkgLock(int max_attempts = 10);
+};
+
+#endif // CMDRETRY_H
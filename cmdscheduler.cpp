@@ -0,0 +1,335 @@
+/**********************************************************************
+ *  cmdscheduler.cpp
+ **********************************************************************
+ * Copyright (C) 2017 MX Authors
+ *
+ * Authors: Adrian
+ *          MX Linux <http://forum.mxlinux.org>
+ *
+ * This is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package. If not, see <http://www.gnu.org/licenses/>.
+ **********************************************************************/
+
+#include <QDebug>
+#include <QFile>
+
+#include "cmdscheduler.h"
+
+// avg10 of the "some" line in /proc/pressure/<resource>, 0 without PSI support
+static double pressure(const QString &resource)
+{
+    QFile file("/proc/pressure/" + resource);
+    if (!file.open(QFile::ReadOnly)) {
+        return 0;
+    }
+    const QByteArray line = file.readLine();
+    const int start = line.indexOf("avg10=");
+    if (!line.startsWith("some") || start < 0) {
+        return 0;
+    }
+    return line.mid(start + 6, line.indexOf(' ', start) - start - 6).toDouble();
+}
+
+CmdScheduler::CmdScheduler(int max_running, QObject *parent) :
+    QObject(parent), max_running(qMax(1, max_running)), pressure_slots(this->max_running)
+{
+    // coalesce scheduling requests and keep starts out of Cmd signal handlers
+    trigger = new QTimer(this);
+    trigger->setSingleShot(true);
+    trigger->setInterval(0);
+    connect(trigger, &QTimer::timeout, this, &CmdScheduler::schedule);
+
+    pressure_timer = new QTimer(this);
+    pressure_timer->setInterval(1000);
+    connect(pressure_timer, &QTimer::timeout, this, &CmdScheduler::updatePressure);
+}
+
+CmdScheduler::~CmdScheduler()
+{
+    queue.clear();
+    for (Cmd *cmd : running.keys()) {
+        cmd->disconnect(this);
+    }
+}
+
+bool CmdScheduler::cancel(int id)
+{
+    if (retrying.remove(id) > 0) {
+        return true;
+    }
+    for (int i = 0; i < queue.size(); ++i) {
+        if (queue.at(i).id == id) {
+            queue.removeAt(i);
+            return true;
+        }
+    }
+    for (auto it = running.constBegin(); it != running.constEnd(); ++it) {
+        if (it.value().id == id) {
+            Cmd *cmd = it.key();
+            return (cmd->terminate() || cmd->kill());
+        }
+    }
+    return false;
+}
+
+// queue a command, returns the job id used in jobStarted/jobFinished
+int CmdScheduler::submit(const QString &cmd_str, Priority priority, const QStringList &options,
+                         const QStringList &resources)
+{
+    Job job;
+    job.attempt = 1;
+    job.id = next_id++;
+    job.priority = priority;
+    job.cmd_str = cmd_str;
+    job.options = options;
+    job.resources = resources;
+    job.retry = retry_policy;
+    if (priority == Background && !job.options.contains("background")) {
+        job.options << "background"; // idle cpu and I/O class for the child too
+    }
+    job.queued.start();
+    queue << job;
+    trigger->start();
+    return job.id;
+}
+
+int CmdScheduler::getQueued() const
+{
+    return queue.size();
+}
+
+int CmdScheduler::getRunning() const
+{
+    return running.size();
+}
+
+void CmdScheduler::setAging(int msecs)
+{
+    aging = msecs;
+}
+
+int CmdScheduler::getAging() const
+{
+    return aging;
+}
+
+void CmdScheduler::setDebug(int level)
+{
+    debug = level;
+    for (Cmd *cmd : idle) cmd->setDebug(level);
+    for (Cmd *cmd : running.keys()) cmd->setDebug(level);
+}
+
+int CmdScheduler::getDebug() const
+{
+    return debug;
+}
+
+void CmdScheduler::setMaxRunning(int count)
+{
+    max_running = qMax(1, count);
+    pressure_slots = qMin(pressure_slots, max_running);
+    if (!usePressure()) pressure_slots = max_running;
+    trigger->start();
+}
+
+int CmdScheduler::getMaxRunning() const
+{
+    return max_running;
+}
+
+void CmdScheduler::setPressureLimits(double cpu, double memory, double io)
+{
+    pressure_limits[0] = cpu;
+    pressure_limits[1] = memory;
+    pressure_limits[2] = io;
+    if (!usePressure()) {
+        pressure_timer->stop();
+        pressure_slots = max_running;
+    }
+    trigger->start();
+}
+
+void CmdScheduler::setRetryPolicy(const CmdRetryPolicy &policy)
+{
+    retry_policy = policy;
+}
+
+bool CmdScheduler::setJobRetryPolicy(int id, const CmdRetryPolicy &policy)
+{
+    for (Job &job : queue) {
+        if (job.id == id) {
+            job.retry = policy;
+            return true;
+        }
+    }
+    return false;
+}
+
+void CmdScheduler::setReservedInteractive(int count)
+{
+    reserved = qMax(0, count);
+    trigger->start();
+}
+
+int CmdScheduler::getReservedInteractive() const
+{
+    return reserved;
+}
+
+// start the best queued jobs while there are free slots
+void CmdScheduler::schedule()
+{
+    if (usePressure()) {
+        if (queue.isEmpty()) {
+            pressure_timer->stop();
+            return;
+        }
+        if (!pressure_timer->isActive()) {
+            pressure_timer->start();
+        }
+        if (!pressure_checked.isValid() || pressure_checked.hasExpired(pressure_timer->interval())) {
+            updatePressure();
+            return; // updatePressure() calls back with the new limit
+        }
+    }
+    while (!queue.isEmpty() && running.size() < pressure_slots) {
+        int best = -1;
+        int best_priority = 0;
+        for (int i = 0; i < queue.size(); ++i) { // queue is in submit order, first wins ties
+            if (isBlocked(queue.at(i))) {
+                continue; // waits for its resources instead of failing on the lock
+            }
+            const int priority = effectivePriority(queue.at(i));
+            if (best == -1 || priority < best_priority) {
+                best = i;
+                best_priority = priority;
+            }
+        }
+        if (best == -1) {
+            return; // everything queued waits for a resource
+        }
+        // the last reserved slots only take interactive (or aged into interactive) jobs
+        if (best_priority > Interactive && running.size() >= qMax(1, pressure_slots - reserved)) {
+            return;
+        }
+        const Job job = queue.takeAt(best);
+        Cmd *cmd = takeWorker();
+        running.insert(cmd, job);
+        for (const QString &resource : job.resources) {
+            locked.insert(resource);
+        }
+        if (debug >= 2) qDebug() << "starting job" << job.id << "priority" << job.priority;
+        if (!cmd->start(job.cmd_str, job.options)) {
+            for (const QString &resource : job.resources) {
+                locked.remove(resource);
+            }
+            running.remove(cmd);
+            idle << cmd;
+            emit jobFinished(job.id, -1, QString(), QString());
+            continue;
+        }
+        emit jobStarted(job.id);
+    }
+}
+
+Cmd *CmdScheduler::takeWorker()
+{
+    if (!idle.isEmpty()) {
+        return idle.takeLast();
+    }
+    Cmd *cmd = new Cmd(this);
+    cmd->setDebug(debug);
+    connect(cmd, &Cmd::finished, this, [this, cmd]() { onJobFinished(cmd); });
+    return cmd;
+}
+
+bool CmdScheduler::isBlocked(const Job &job) const
+{
+    for (const QString &resource : job.resources) {
+        if (locked.contains(resource)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool CmdScheduler::usePressure() const
+{
+    return (pressure_limits[0] > 0 || pressure_limits[1] > 0 || pressure_limits[2] > 0);
+}
+
+// halve the launch limit while any resource is over its threshold, then ramp it
+// back up one slot per interval once pressure falls
+void CmdScheduler::updatePressure()
+{
+    pressure_checked.start();
+    static const char *resources[] = { "cpu", "memory", "io" };
+    bool over = false;
+    for (int i = 0; i < 3; ++i) {
+        if (pressure_limits[i] > 0 && pressure(resources[i]) > pressure_limits[i]) {
+            over = true;
+        }
+    }
+    const int slots = over ? qMax(1, pressure_slots / 2) : qMin(max_running, pressure_slots + 1);
+    if (slots != pressure_slots && debug >= 2) qDebug() << "pressure launch limit:" << slots;
+    pressure_slots = slots;
+    schedule();
+}
+
+// lower is better, each "aging" interval spent waiting promotes the job one class
+int CmdScheduler::effectivePriority(const Job &job) const
+{
+    if (aging <= 0) {
+        return job.priority;
+    }
+    return qMax(int(Interactive), job.priority - int(job.queued.elapsed() / aging));
+}
+
+void CmdScheduler::onJobFinished(Cmd *cmd)
+{
+    auto it = running.find(cmd);
+    if (it == running.end()) {
+        return;
+    }
+    Job job = it.value();
+    for (const QString &resource : job.resources) {
+        locked.remove(resource);
+    }
+    running.erase(it);
+    idle << cmd;
+    const int exit_code = cmd->getExitCode(true);
+    if (cmd->getStopReason() == Cmd::NotStopped && job.retry.mayRetry(job.attempt, exit_code)
+            && (job.retry.pattern.pattern().isEmpty()
+                || job.retry.shouldRetry(job.attempt, exit_code, cmd->getOutput(), cmd->getError()))) {
+        // requeue from a timer instead of spinning on the failure, the job keeps
+        // its original queue time so aging still applies
+        const int delay = job.retry.delay(job.attempt);
+        emit jobRetrying(job.id, job.attempt, delay);
+        const int id = job.id;
+        ++job.attempt;
+        retrying.insert(id, job);
+        QTimer::singleShot(delay, this, [this, id]() {
+            auto retry = retrying.find(id);
+            if (retry == retrying.end()) {
+                return; // cancelled meanwhile
+            }
+            queue << retry.value();
+            retrying.erase(retry);
+            trigger->start();
+        });
+    } else {
+        emit jobFinished(job.id, exit_code, cmd->getOutput(), cmd->getError());
+    }
+    trigger->start();
+}
@@ -0,0 +1,123 @@
+/**********************************************************************
+ *  cmdscheduler.h
+ **********************************************************************
+ * Copyright (C) 2017 MX Authors
+ *
+ * Authors: Adrian
+ *          MX Linux <http://forum.mxlinux.org>
+ *
+ * This is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package. If not, see <http://www.gnu.org/licenses/>.
+ **********************************************************************/
+
+
+#ifndef CMDSCHEDULER_H
+#define CMDSCHEDULER_H
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+#include <QSet>
+#include <QTimer>
+
+#include "cmd.h"
+
+// runs queued commands on a pool of Cmd workers, at most max_running at once;
+// higher priority classes go first, waiting jobs age into higher classes so
+// background work is not starved
+class CMDSHARED_EXPORT CmdScheduler: public QObject
+{
+    Q_OBJECT
+public:
+    enum Priority { Interactive, Normal, Background };
+
+    explicit CmdScheduler(int max_running = 4, QObject *parent = 0);
+    ~CmdScheduler();
+
+    bool cancel(int id); // drops a queued job or terminates a running one
+    // jobs naming the same resource (e.g. "dpkg") never run at the same time
+    int submit(const QString &cmd_str, Priority priority = Normal, const QStringList &options = QStringList(""),
+               const QStringList &resources = QStringList());
+
+    int getQueued() const;
+    int getRunning() const;
+
+    // waiting this long promotes a job by one priority class
+    void setAging(int msecs);
+    int getAging() const;
+
+    void setDebug(int level);
+    int getDebug() const;
+
+    void setMaxRunning(int count);
+    int getMaxRunning() const;
+
+    // throttle launches while /proc/pressure avg10 "some" exceeds these
+    // percentages, 0 disables the check for that resource
+    void setPressureLimits(double cpu, double memory, double io);
+
+    // retry policy for jobs submitted from now on, and for one queued job
+    void setRetryPolicy(const CmdRetryPolicy &policy);
+    bool setJobRetryPolicy(int id, const CmdRetryPolicy &policy);
+
+    // slots kept free for interactive jobs while others are waiting
+    void setReservedInteractive(int count);
+    int getReservedInteractive() const;
+
+signals:
+    void jobFinished(int id, int exit_code, const QString &output, const QString &error);
+    void jobRetrying(int id, int attempt, int delay); // attempt that failed, ms until requeued
+    void jobStarted(int id);
+
+private slots:
+    void schedule();
+    void updatePressure();
+
+private:
+    struct Job
+    {
+        int attempt;
+        int id;
+        Priority priority;
+        QElapsedTimer queued;
+        QString cmd_str;
+        QStringList options;
+        QStringList resources;
+        CmdRetryPolicy retry;
+    };
+
+    int aging = 10000;
+    int debug = 2;
+    int max_running;
+    int next_id = 1;
+    int pressure_slots;  // launch limit lowered under pressure
+    int reserved = 1;
+    double pressure_limits[3] = {0, 0, 0}; // cpu, memory, io
+    CmdRetryPolicy retry_policy;
+    QHash<Cmd *, Job> running;
+    QHash<int, Job> retrying; // failed jobs waiting for their backoff timer
+    QList<Cmd *> idle;
+    QList<Job> queue;
+    QSet<QString> locked; // resources held by running jobs
+    QElapsedTimer pressure_checked;
+    QTimer *pressure_timer;
+    QTimer *trigger;
+
+    Cmd *takeWorker();
+    bool isBlocked(const Job &job) const;
+    bool usePressure() const;
+    int effectivePriority(const Job &job) const;
+    void onJobFinished(Cmd *cmd);
+};
+
+#endif // CMDSCHEDULER_H
@@ -0,0 +1,142 @@
+/**********************************************************************
+ *  cmdsearchindex.cpp
+ **********************************************************************
+ * Copyright (C) 2017 MX Authors
+ *
+ * Authors: Adrian
+ *          MX Linux <http://forum.mxlinux.org>
+ *
+ * This is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package. If not, see <http://www.gnu.org/licenses/>.
+ **********************************************************************/
+
+#include "cmdsearchindex.h"
+
+#include <algorithm>
+
+int CmdSearchIndex::lineCount() const
+{
+    return splitter.hasPartial() ? lines + 1 : lines;
+}
+
+// intersect the block lists starting with the shortest and expand the blocks left
+// to their lines, needles under three characters can't be narrowed and get every line
+QVector<int> CmdSearchIndex::candidates(const QString &needle) const
+{
+    QVector<int> result;
+    QVector<quint64> keys = trigrams(needle);
+    if (keys.isEmpty()) {
+        result.reserve(lineCount());
+        for (int n = 0; n < lineCount(); ++n) {
+            result.append(n);
+        }
+        return result;
+    }
+    QVector<const Postings *> lists;
+    for (quint64 key : keys) {
+        auto it = postings.constFind(key);
+        if (it == postings.constEnd()) {
+            lists.clear();
+            break;
+        }
+        lists.append(&it.value());
+    }
+    if (!lists.isEmpty()) {
+        std::sort(lists.begin(), lists.end(), [](const Postings *a, const Postings *b) { return a->deltas.size() < b->deltas.size(); });
+        QVector<int> blocks = decode(lists.first()->deltas);
+        for (int i = 1; i < lists.size() && !blocks.isEmpty(); ++i) {
+            const QVector<int> other = decode(lists.at(i)->deltas);
+            QVector<int> merged;
+            std::set_intersection(blocks.cbegin(), blocks.cend(), other.cbegin(), other.cend(), std::back_inserter(merged));
+            blocks = merged;
+        }
+        for (int block : blocks) {
+            const int last = qMin((block + 1) * BlockLines, lines);
+            for (int n = block * BlockLines; n < last; ++n) {
+                result.append(n);
+            }
+        }
+    }
+    // the unterminated last line is not indexed yet
+    if (splitter.hasPartial() && splitter.partial().contains(needle, Qt::CaseInsensitive)) {
+        result.append(lines);
+    }
+    return result;
+}
+
+void CmdSearchIndex::append(const QString &chunk)
+{
+    splitter.split(chunk, [this](const QString &line) { addLine(line); });
+}
+
+void CmdSearchIndex::clear()
+{
+    lines = 0;
+    postings.clear();
+    splitter.clear();
+}
+
+QVector<int> CmdSearchIndex::decode(const QByteArray &deltas)
+{
+    QVector<int> blocks;
+    int block = -1;
+    int delta = 0;
+    int shift = 0;
+    for (char byte : deltas) {
+        delta |= (byte & 0x7f) << shift;
+        if (byte & 0x80) {
+            shift += 7;
+            continue;
+        }
+        block += delta;
+        blocks.append(block);
+        delta = 0;
+        shift = 0;
+    }
+    return blocks;
+}
+
+// distinct case folded trigrams, three UTF-16 units packed in one key
+QVector<quint64> CmdSearchIndex::trigrams(const QString &text)
+{
+    QVector<quint64> keys;
+    const QString folded = text.toCaseFolded();
+    keys.reserve(qMax(0, folded.size() - 2));
+    for (int i = 0; i + 2 < folded.size(); ++i) {
+        keys.append(quint64(folded.at(i).unicode()) << 32 | quint64(folded.at(i + 1).unicode()) << 16
+                    | folded.at(i + 2).unicode());
+    }
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+    return keys;
+}
+
+void CmdSearchIndex::addLine(const QString &line)
+{
+    const int block = lines / BlockLines;
+    for (quint64 key : trigrams(line)) {
+        Postings &list = postings[key];
+        if (list.last == block) {
+            continue;
+        }
+        for (uint delta = uint(block - list.last); ; delta >>= 7) {
+            if (delta < 0x80) {
+                list.deltas.append(char(delta));
+                break;
+            }
+            list.deltas.append(char(0x80 | (delta & 0x7f)));
+        }
+        list.last = block;
+    }
+    ++lines;
+}
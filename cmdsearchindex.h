@@ -0,0 +1,65 @@
+/**********************************************************************
+ *  cmdsearchindex.h
+ **********************************************************************
+ * Copyright (C) 2017 MX Authors
+ *
+ * Authors: Adrian
+ *          MX Linux <http://forum.mxlinux.org>
+ *
+ * This is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package. If not, see <http://www.gnu.org/licenses/>.
+ **********************************************************************/
+
+
+#ifndef CMDSEARCHINDEX_H
+#define CMDSEARCHINDEX_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QString>
+#include <QVector>
+
+#include "cmd_global.h"
+#include "cmdlinesplitter.h"
+
+// trigram index over output lines, built as chunks arrive; candidates() narrows a
+// search to the lines holding every trigram of the needle (case folded), callers
+// still check those lines for the actual match. Postings point at blocks of lines
+// and are stored as varint deltas, so the index stays a fraction of the text size
+class CMDSHARED_EXPORT CmdSearchIndex
+{
+public:
+    enum { BlockLines = 64 }; // lines per posting entry
+
+    int lineCount() const; // an unterminated last line counts
+    QVector<int> candidates(const QString &needle) const; // ascending line numbers
+    void append(const QString &chunk);
+    void clear();
+
+private:
+    struct Postings
+    {
+        int last = -1;      // last block added
+        QByteArray deltas;  // block numbers, each as a varint delta to the previous one
+    };
+
+    int lines = 0; // complete lines indexed
+    QHash<quint64, Postings> postings; // trigram -> blocks containing it
+    CmdLineSplitter splitter;
+
+    static QVector<int> decode(const QByteArray &deltas);
+    static QVector<quint64> trigrams(const QString &text);
+    void addLine(const QString &line);
+};
+
+#endif // CMDSEARCHINDEX_H
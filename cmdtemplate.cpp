@@ -0,0 +1,82 @@
+/**********************************************************************
+ *  cmdtemplate.cpp
+ **********************************************************************
+ * Copyright (C) 2017 MX Authors
+ *
+ * Authors: Adrian
+ *          MX Linux <http://forum.mxlinux.org>
+ *
+ * This is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package. If not, see <http://www.gnu.org/licenses/>.
+ **********************************************************************/
+
+#include <QDebug>
+#include <QRegularExpression>
+
+#include "cmdtemplate.h"
+
+// single quotes unless the argument is made of characters bash leaves alone
+QString CmdTemplate::quote(const QString &arg)
+{
+    static const QRegularExpression safe("^[A-Za-z0-9_./:=@%+,-]+$");
+    if (safe.match(arg).hasMatch()) {
+        return arg;
+    }
+    return "'" + QString(arg).replace("'", "'\\''") + "'";
+}
+
+void CmdTemplate::invalid(const char *message)
+{
+    valid = false;
+    placeholders = 0;
+    tokens = 0;
+    qWarning() << message;
+    Q_ASSERT_X(false, "CmdTemplate", message);
+}
+
+// skeleton text with quoted arguments in place of the placeholders, the fixed
+// parts are copied verbatim
+QString CmdTemplate::render(const QStringList &args) const
+{
+    if (!valid) {
+        return "false"; // runs and fails instead of bash -c "" succeeding
+    }
+    QString result;
+    int pos = 0;
+    for (int i = 0; i < placeholders; ++i) {
+        result += QString::fromUtf8(text + pos, placeholder[i] - pos);
+        result += quote(args.value(i));
+        pos = placeholder[i] + 2;
+    }
+    result += QString::fromUtf8(text + pos, length - pos);
+    return result;
+}
+
+// one entry per skeleton token, using the token boundaries found at compile time
+QStringList CmdTemplate::split(const QStringList &args) const
+{
+    QStringList argv;
+    int next = 0; // next placeholder
+    for (int t = 0; t < tokens; ++t) {
+        QString token;
+        int pos = token_begin[t];
+        for (; next < placeholders && placeholder[next] < token_end[t]; ++next) {
+            token += QString::fromUtf8(text + pos, placeholder[next] - pos);
+            token += args.value(next);
+            pos = placeholder[next] + 2;
+        }
+        token += QString::fromUtf8(text + pos, token_end[t] - pos);
+        argv << token;
+    }
+    return argv;
+}
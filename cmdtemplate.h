@@ -0,0 +1,148 @@
+/**********************************************************************
+ *  cmdtemplate.h
+ **********************************************************************
+ * Copyright (C) 2017 MX Authors
+ *
+ * Authors: Adrian
+ *          MX Linux <http://forum.mxlinux.org>
+ *
+ * This is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package. If not, see <http://www.gnu.org/licenses/>.
+ **********************************************************************/
+
+
+#ifndef CMDTEMPLATE_H
+#define CMDTEMPLATE_H
+
+#include <QStringList>
+
+#include "cmd_global.h"
+
+// command skeleton with {} placeholders, parsed and validated at compile time when
+// declared constexpr; at runtime only the arguments are substituted:
+//
+//   static constexpr CmdTemplate mount_cmd("mount -o ro {} {}");
+//   static_assert(mount_cmd.arity() == 2, "");
+//   cmd.exec(mount_cmd.argv(device, dir));    // direct exec, no quoting needed
+//   cmd.run(mount_cmd.command(device, dir));  // through bash, arguments quoted
+//
+// {} inside quotes is literal text (e.g. find -exec rm '{}' \;). Skeletons using
+// quotes or shell syntax can only be run through bash, see needsShell().
+// Needs C++14 (CONFIG += c++14), the constexpr constructor uses loops.
+class CMDSHARED_EXPORT CmdTemplate
+{
+public:
+    enum { MaxPlaceholders = 16, MaxTokens = 32 };
+
+    template <int N>
+    constexpr CmdTemplate(const char (&skeleton)[N]) :
+        text(skeleton), length(N - 1), placeholders(0), tokens(0), shell(false), valid(true), placeholder{}, token_begin{}, token_end{}
+    {
+        char quote = 0;
+        bool in_token = false;
+        for (int i = 0; i < length; ++i) {
+            const char c = text[i];
+            if (quote) {
+                if (c == quote) quote = 0;
+                continue;
+            }
+            const bool space = (c == ' ' || c == '\t' || c == '\n');
+            if (!space && !in_token) {
+                if (tokens == MaxTokens) { invalid("too many tokens in command template"); return; }
+                token_begin[tokens] = i;
+                in_token = true;
+            } else if (space && in_token) {
+                token_end[tokens++] = i;
+                in_token = false;
+            }
+            if (c == '\'' || c == '"') {
+                quote = c;
+                shell = true;
+            } else if (c == '{' && i + 1 < length && text[i + 1] == '}') {
+                if (placeholders == MaxPlaceholders) { invalid("too many placeholders in command template"); return; }
+                placeholder[placeholders++] = i++;
+            } else if (c == '{' || c == '}') {
+                invalid("unmatched brace in command template, use {} or quote it");
+                return;
+            } else if (isShellChar(c)) {
+                shell = true;
+            }
+        }
+        if (quote) { invalid("unterminated quote in command template"); return; }
+        if (in_token) token_end[tokens++] = length;
+        if (tokens == 0) { invalid("empty command template"); return; }
+    }
+
+    constexpr int arity() const { return placeholders; }
+    constexpr bool isValid() const { return valid; } // false for a runtime template that failed to parse
+    constexpr bool needsShell() const { return shell; }
+
+    // string for Cmd::run(), each argument is quoted for bash; "false" for an invalid template
+    template <typename... Args>
+    QString command(const Args &... args) const
+    {
+        return render(toArgs(args...));
+    }
+
+    // argument vector for Cmd::exec(), a placeholder never splits into several arguments;
+    // empty (exec() fails) for an invalid template or one that needs the shell
+    template <typename... Args>
+    QStringList argv(const Args &... args) const
+    {
+        Q_ASSERT_X(!shell, "CmdTemplate::argv", "template uses shell syntax, use command()");
+        if (!valid || shell) {
+            return QStringList();
+        }
+        return split(toArgs(args...));
+    }
+
+    static QString quote(const QString &arg);
+
+private:
+    const char *text;
+    int length;
+    int placeholders;
+    int tokens;
+    bool shell;
+    bool valid;
+    int placeholder[MaxPlaceholders]; // offset of each {}
+    int token_begin[MaxTokens];
+    int token_end[MaxTokens];
+
+    static constexpr bool isShellChar(char c)
+    {
+        return (c == '|' || c == '&' || c == ';' || c == '<' || c == '>' || c == '(' || c == ')' || c == '$'
+                || c == '`' || c == '\\' || c == '*' || c == '?' || c == '[' || c == ']' || c == '#' || c == '~');
+    }
+
+    // not constexpr on purpose: reaching it while evaluating a constexpr template is a
+    // compile error, at runtime it marks the template unusable and parsing stops
+    void invalid(const char *message);
+
+    static QString toArg(const QString &arg) { return arg; }
+    static QString toArg(const char *arg) { return QString::fromUtf8(arg); }
+    static QString toArg(int arg) { return QString::number(arg); }
+    static QString toArg(qint64 arg) { return QString::number(arg); }
+
+    template <typename... Args>
+    QStringList toArgs(const Args &... args) const
+    {
+        Q_ASSERT_X(int(sizeof...(args)) == placeholders, "CmdTemplate", "wrong number of arguments");
+        return QStringList{ toArg(args)... };
+    }
+
+    QString render(const QStringList &args) const;
+    QStringList split(const QStringList &args) const;
+};
+
+#endif // CMDTEMPLATE_H
@@ -0,0 +1,253 @@
+/**********************************************************************
+ *  main.cpp
+ **********************************************************************
+ * Copyright (C) 2017 MX Authors
+ *
+ * Authors: Adrian
+ *          MX Linux <http://forum.mxlinux.org>
+ *
+ * This is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package. If not, see <http://www.gnu.org/licenses/>.
+ **********************************************************************/
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QProcess>
+#include <QTimer>
+
+#include <memory>
+
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "cmdhelperprotocol.h"
+
+using namespace CmdHelperProtocol;
+
+static const int idle_timeout = 10 * 60 * 1000; // exit after 10 minutes without clients
+
+// the user pkexec (or sudo) authenticated, never taken from the command line
+static bool callerUid(uid_t *uid)
+{
+    QByteArray value = qgetenv("PKEXEC_UID");
+    if (value.isEmpty()) value = qgetenv("SUDO_UID");
+    bool ok;
+    *uid = value.toUInt(&ok);
+    return ok;
+}
+
+// compare without an early exit, the time taken says nothing about the token
+static bool tokenMatches(const QByteArray &token, const QByteArray &expected)
+{
+    if (token.size() != expected.size()) {
+        return false;
+    }
+    char diff = 0;
+    for (int i = 0; i < token.size(); ++i) {
+        diff |= token.at(i) ^ expected.at(i);
+    }
+    return diff == 0;
+}
+
+static bool peerAllowed(QLocalSocket *socket, uid_t uid)
+{
+    struct ucred cred;
+    socklen_t len = sizeof(cred);
+    if (getsockopt(int(socket->socketDescriptor()), SOL_SOCKET, SO_PEERCRED, &cred, &len) != 0) {
+        return false;
+    }
+    return (cred.uid == uid || cred.uid == 0);
+}
+
+// runs the commands requested on one connection, one at a time, and streams back the results
+static void serve(QLocalSocket *socket, const QByteArray &token)
+{
+    QProcess *proc = new QProcess(socket);
+    std::shared_ptr<QByteArray> buffer(new QByteArray);
+
+    QObject::connect(proc, &QProcess::started, [socket, proc]() {
+        socket->write(frame(Started, encode(qint64(proc->processId()))));
+    });
+    QObject::connect(proc, &QProcess::readyReadStandardOutput, [socket, proc]() {
+        socket->write(frame(Output, encode(proc->readAllStandardOutput())));
+    });
+    QObject::connect(proc, &QProcess::readyReadStandardError, [socket, proc]() {
+        socket->write(frame(Error, encode(proc->readAllStandardError())));
+    });
+    QObject::connect(proc, static_cast<void (QProcess::*)(int, QProcess::ExitStatus)>(&QProcess::finished),
+                     [socket](int exit_code, QProcess::ExitStatus exit_status) {
+        socket->write(frame(Finished, encode(qint32(exit_code), qint32(exit_status))));
+        socket->flush();
+    });
+    QObject::connect(proc, &QProcess::errorOccurred, [socket](QProcess::ProcessError error) {
+        if (error == QProcess::FailedToStart) socket->write(frame(FailedToStart));
+    });
+
+    QObject::connect(socket, &QLocalSocket::readyRead, [socket, proc, buffer, token]() {
+        *buffer += socket->readAll();
+        quint8 type;
+        QByteArray payload;
+        while (takeFrame(*buffer, type, payload)) {
+            QDataStream stream(payload);
+            stream.setVersion(QDataStream::Qt_5_0);
+            if (type == Start && proc->state() == QProcess::NotRunning) {
+                QByteArray client_token;
+                QString program;
+                QStringList arguments;
+                stream >> client_token >> program >> arguments;
+                if (!tokenMatches(client_token, token)) {
+                    qWarning() << "cmd-helper: rejected command with a wrong session token";
+                    socket->write(frame(FailedToStart));
+                    socket->flush();
+                    socket->disconnectFromServer();
+                    return;
+                }
+                proc->start(program, arguments);
+            } else if (type == Write) {
+                QByteArray data;
+                stream >> data;
+                proc->write(data);
+            } else if (type == Signal) {
+                qint32 sig;
+                stream >> sig;
+                if (proc->processId() > 0) ::kill(pid_t(proc->processId()), sig);
+            }
+        }
+    });
+
+    // client gone, do not leave its command running as root
+    QObject::connect(socket, &QLocalSocket::disconnected, [proc]() {
+        if (proc->state() != QProcess::NotRunning) {
+            proc->kill();
+            proc->waitForFinished(1000);
+        }
+    });
+}
+
+// session token and client pid, one line each on stdin
+static bool readSession(QByteArray *token, qint64 *client_pid)
+{
+    QFile input;
+    if (!input.open(stdin, QIODevice::ReadOnly)) {
+        return false;
+    }
+    *token = input.readLine(256).trimmed();
+    bool ok;
+    *client_pid = input.readLine(32).trimmed().toLongLong(&ok);
+    return ok && token->size() >= 32;
+}
+
+int main(int argc, char *argv[])
+{
+    // the parent stays behind as the process pkexec waits for and only exits once the
+    // daemon listens, so the client learns from pkexec's exit status if it came up
+    int ready[2];
+    if (pipe(ready) != 0) {
+        return 1;
+    }
+    const pid_t daemon = fork();
+    if (daemon < 0) {
+        return 1;
+    }
+    if (daemon > 0) {
+        close(ready[1]);
+        char status = 0;
+        return (read(ready[0], &status, 1) == 1 && status == 1) ? 0 : 1;
+    }
+    close(ready[0]);
+    setsid();
+
+    QCoreApplication app(argc, argv);
+
+    if (geteuid() != 0) {
+        qWarning() << "cmd-helper needs to be started as root, through pkexec";
+        return 1;
+    }
+    uid_t uid;
+    if (!callerUid(&uid)) {
+        qWarning() << "cmd-helper: PKEXEC_UID is not set";
+        return 1;
+    }
+    QByteArray token;
+    qint64 client_pid;
+    if (!readSession(&token, &client_pid)) {
+        qWarning() << "cmd-helper: no session token on stdin";
+        return 1;
+    }
+
+    // root owned directory, the socket itself belongs to the user with mode 0600
+    const QString path = socketPath(uid, client_pid);
+    QDir().mkpath(QFileInfo(path).path());
+    chmod(QFile::encodeName(QFileInfo(path).path()).constData(), 0755);
+    QLocalServer::removeServer(path);
+    QLocalServer server;
+    server.setSocketOptions(QLocalServer::UserAccessOption);
+    if (!server.listen(path)) {
+        qWarning() << "cmd-helper: could not listen on" << path << server.errorString();
+        return 1;
+    }
+    if (chown(QFile::encodeName(path).constData(), uid, gid_t(-1)) != 0
+            || chmod(QFile::encodeName(path).constData(), 0600) != 0) {
+        qWarning() << "cmd-helper: could not set owner of" << path;
+        return 1;
+    }
+
+    // detach from pkexec's stdio and let it exit
+    const int null_fd = open("/dev/null", O_RDWR);
+    if (null_fd >= 0) {
+        dup2(null_fd, STDIN_FILENO);
+        dup2(null_fd, STDOUT_FILENO);
+        dup2(null_fd, STDERR_FILENO);
+        if (null_fd > STDERR_FILENO) close(null_fd);
+    }
+    const char status = 1;
+    if (write(ready[1], &status, 1) != 1) {
+        return 1;
+    }
+    close(ready[1]);
+
+    QTimer idle;
+    idle.setSingleShot(true);
+    idle.setInterval(idle_timeout);
+    QObject::connect(&idle, &QTimer::timeout, &app, &QCoreApplication::quit);
+    idle.start();
+
+    int sessions = 0;
+    QObject::connect(&server, &QLocalServer::newConnection, [&]() {
+        while (QLocalSocket *socket = server.nextPendingConnection()) {
+            if (!peerAllowed(socket, uid)) {
+                qWarning() << "cmd-helper: rejected connection from another user";
+                socket->abort();
+                socket->deleteLater();
+                continue;
+            }
+            ++sessions;
+            idle.stop();
+            QObject::connect(socket, &QLocalSocket::disconnected, [&, socket]() {
+                socket->deleteLater();
+                if (--sessions == 0) idle.start();
+            });
+            serve(socket, token);
+        }
+    });
+
+    return app.exec();
+}
@@ -0,0 +1,31 @@
+# **********************************************************************
+# * Copyright (C) 2017 MX Authors
+# *
+# * Authors: Adrian
+# *          MX Linux <http://mxlinux.org>
+# *
+# * This is free software: you can redistribute it and/or modify
+# * it under the terms of the GNU General Public License as published by
+# * the Free Software Foundation, either version 3 of the License, or
+# * (at your option) any later version.
+# *
+# * This program is distributed in the hope that it will be useful,
+# * but WITHOUT ANY WARRANTY; without even the implied warranty of
+# * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# * GNU General Public License for more details.
+# *
+# * You should have received a copy of the GNU General Public License
+# * along with this package. If not, see <http://www.gnu.org/licenses/>.
+# **********************************************************************/
+
+QT       -= gui
+
+TARGET = cmdbench
+TEMPLATE = app
+CONFIG += console
+CONFIG -= app_bundle
+
+SOURCES += main.cpp
+
+INCLUDEPATH += ../..
+LIBS += -L../.. -lcmd
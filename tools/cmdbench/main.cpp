@@ -0,0 +1,231 @@
+/**********************************************************************
+ *  main.cpp
+ **********************************************************************
+ * Copyright (C) 2017 MX Authors
+ *
+ * Authors: Adrian
+ *          MX Linux <http://forum.mxlinux.org>
+ *
+ * This is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package. If not, see <http://www.gnu.org/licenses/>.
+ **********************************************************************/
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <QTimer>
+
+#include <algorithm>
+#include <numeric>
+
+#include "cmd.h"
+#include "cmdhelper.h"
+#include "cmdmock.h"
+
+static QTextStream out(stdout);
+
+// print the latency distribution of the samples (in nanoseconds) and the message rate
+static void report(const QString &name, QVector<qint64> samples, qint64 total_ns, int lost = 0)
+{
+    out << name << ": " << samples.size() << " samples";
+    if (lost > 0) out << ", " << lost << " lost";
+    out << "\n";
+    if (samples.isEmpty() || total_ns <= 0) {
+        out.flush();
+        return;
+    }
+    std::sort(samples.begin(), samples.end());
+    auto usec = [&samples](double p) {
+        int i = qMin(samples.size() - 1, int(p * samples.size()));
+        return QString::number(samples.at(i) / 1000.0, 'f', 1);
+    };
+    qint64 sum = std::accumulate(samples.constBegin(), samples.constEnd(), qint64(0));
+    out << "  latency us: min " << usec(0) << "  p50 " << usec(0.5) << "  p90 " << usec(0.9)
+        << "  p99 " << usec(0.99) << "  max " << usec(1) << "  mean "
+        << QString::number(sum / 1000.0 / samples.size(), 'f', 1) << "\n";
+    out << "  rate: " << QString::number(samples.size() * 1e9 / total_ns, 'f', 0) << " msg/s\n";
+    out.flush();
+}
+
+// ping-pong between two Cmd instances sharing one FIFO file, each round trip goes
+// writeToFifo -> fifoChanged -> fifoChangeAvailable in both directions
+static void benchFifo(const QString &file_name, int count)
+{
+    Cmd ping, pong;
+    ping.setDebug(0);
+    pong.setDebug(0);
+    if (!ping.connectFifo(file_name) || !pong.connectFifo(file_name)) {
+        out << "fifo: could not open " << file_name << "\n";
+        return;
+    }
+
+    QVector<qint64> samples;
+    samples.reserve(count);
+    QElapsedTimer total, rtt;
+    QEventLoop loop;
+    QTimer timeout;
+    timeout.setSingleShot(true);
+    int seq = 0, lost = 0;
+    QString answered;
+
+    auto send = [&]() {
+        if (seq >= count) {
+            timeout.stop();
+            loop.quit();
+            return;
+        }
+        timeout.start(1000); // count a message as lost if no reply within a second
+        rtt.start();
+        ping.writeToFifo(QString("ping %1").arg(seq));
+    };
+
+    // the whole file is delivered on each change, only the last line is the new message
+    QObject::connect(&pong, &Cmd::fifoChangeAvailable, [&](const QString &msg) {
+        const QString last = msg.section('\n', -1);
+        if (last.startsWith("ping ") && last != answered) {
+            answered = last;
+            pong.writeToFifo("pong " + last.mid(5));
+        }
+    });
+    QObject::connect(&ping, &Cmd::fifoChangeAvailable, [&](const QString &msg) {
+        if (msg.section('\n', -1) == QString("pong %1").arg(seq)) {
+            samples << rtt.nsecsElapsed();
+            ++seq;
+            send();
+        }
+    });
+    QObject::connect(&timeout, &QTimer::timeout, [&]() {
+        ++lost;
+        ++seq;
+        send();
+    });
+
+    total.start();
+    QTimer::singleShot(0, send);
+    loop.exec();
+    report("fifo round trip", samples, total.nsecsElapsed(), lost);
+}
+
+// writer floods the FIFO without waiting, reader timestamps each message as it shows up
+static void benchFifoRate(const QString &file_name, int count)
+{
+    Cmd writer, reader;
+    writer.setDebug(0);
+    reader.setDebug(0);
+    if (!writer.connectFifo(file_name) || !reader.connectFifo(file_name)) {
+        out << "fifo-rate: could not open " << file_name << "\n";
+        return;
+    }
+
+    QVector<qint64> sent(count, 0);
+    QVector<qint64> samples;
+    samples.reserve(count);
+    QElapsedTimer total;
+    QEventLoop loop;
+    int received = 0;
+
+    QObject::connect(&reader, &Cmd::fifoChangeAvailable, [&](const QString &msg) {
+        const qint64 now = total.nsecsElapsed();
+        const QStringList lines = msg.split('\n');
+        for (int i = received; i < lines.size(); ++i) {
+            bool ok;
+            int seq = lines.at(i).section(' ', 1).toInt(&ok);
+            if (ok && seq < count) samples << now - sent.at(seq);
+        }
+        received = lines.size();
+        if (received >= count) loop.quit();
+    });
+    QTimer::singleShot(0, [&]() {
+        for (int i = 0; i < count; ++i) {
+            sent[i] = total.nsecsElapsed();
+            writer.writeToFifo(QString("msg %1").arg(i));
+        }
+    });
+    QTimer::singleShot(30000, &loop, &QEventLoop::quit);
+
+    total.start();
+    loop.exec();
+    report("fifo max rate", samples, total.nsecsElapsed(), count - samples.size());
+}
+
+// spawn a trivial command repeatedly to measure the run() round trip through bash,
+// with the mock backend only the library overhead is measured, no process is spawned;
+// with the helper backend each run also goes over the privileged helper's socket
+static void benchRun(const QString &name, CmdBackend *backend, int count)
+{
+    Cmd cmd;
+    cmd.setDebug(0);
+    if (backend) {
+        cmd.setBackend(backend);
+    }
+    QVector<qint64> samples;
+    samples.reserve(count);
+    QElapsedTimer total, rtt;
+
+    total.start();
+    for (int i = 0; i < count; ++i) {
+        rtt.start();
+        cmd.run("true", QStringList("quiet"));
+        samples << rtt.nsecsElapsed();
+    }
+    report(name, samples, total.nsecsElapsed());
+}
+
+static void benchRunMock(int count)
+{
+    CmdMockBackend *backend = new CmdMockBackend;
+    backend->setSpeed(0);
+    benchRun("run round trip (mock)", backend, count);
+}
+
+// asks for authentication once, not part of "all"
+static void benchRunHelper(int count)
+{
+    if (!CmdHelperBackend::startHelper()) {
+        out << "run-helper: could not start the privileged helper\n";
+        return;
+    }
+    benchRun("run round trip (helper)", new CmdHelperBackend, count);
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("cmdbench");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Microbenchmarks for libcmd IPC round trips");
+    parser.addHelpOption();
+    parser.addPositionalArgument("bench", "Benchmark to run: fifo, fifo-rate, run, run-mock, run-helper or all (default, without run-helper)");
+    QCommandLineOption count_opt(QStringList() << "n" << "count", "Number of messages or commands.", "count", "1000");
+    parser.addOption(count_opt);
+    parser.process(app);
+
+    const QString bench = parser.positionalArguments().value(0, "all");
+    const int count = qMax(1, parser.value(count_opt).toInt());
+
+    QTemporaryDir dir;
+    if (!dir.isValid()) {
+        out << "could not create temporary directory\n";
+        return 1;
+    }
+    if (bench == "fifo" || bench == "all") benchFifo(dir.path() + "/fifo", count);
+    if (bench == "fifo-rate" || bench == "all") benchFifoRate(dir.path() + "/fifo-rate", count);
+    if (bench == "run" || bench == "all") benchRun("run round trip", nullptr, count);
+    if (bench == "run-mock" || bench == "all") benchRunMock(count);
+    if (bench == "run-helper") benchRunHelper(count);
+    return 0;
+}
@@ -0,0 +1,256 @@
+/**********************************************************************
+ *  main.cpp
+ **********************************************************************
+ * Copyright (C) 2017 MX Authors
+ *
+ * Authors: Adrian
+ *          MX Linux <http://forum.mxlinux.org>
+ *
+ * This is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package. If not, see <http://www.gnu.org/licenses/>.
+ **********************************************************************/
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <QTimer>
+
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <functional>
+
+#include "cmd.h"
+#include "cmdmock.h"
+
+static QTextStream out(stdout);
+
+struct Config
+{
+    bool mock;
+    int commands;
+    int concurrency;
+    int fifo_rate;
+    int kill_after;
+    int kill_every;
+    int line_length;
+    int lines;
+    int rate;
+    int stall_every;
+    int stall_ms;
+};
+
+struct Worker
+{
+    Cmd cmd;
+    int job = -1;
+    QElapsedTimer timer;
+};
+
+// resident set size of this process in kB
+static long currentRss()
+{
+    QFile file("/proc/self/status");
+    if (!file.open(QFile::ReadOnly)) {
+        return 0;
+    }
+    for (const QByteArray &line : file.readAll().split('\n')) {
+        if (line.startsWith("VmRSS:")) {
+            return line.mid(6).trimmed().split(' ').first().toLong();
+        }
+    }
+    return 0;
+}
+
+static double seconds(const timeval &tv)
+{
+    return tv.tv_sec + tv.tv_usec / 1e6;
+}
+
+// shell snippet producing the configured output, optionally rate limited in 100 ms chunks
+static QString commandFor(const Config &cfg, int job)
+{
+    const QString line(cfg.line_length, 'x');
+    QString cmd_str;
+    if (cfg.rate > 0) {
+        const int chunk = qMax(1, cfg.rate / 10);
+        cmd_str = QString("for i in $(seq %1); do yes %2 | head -n %3; sleep %4; done")
+                .arg((cfg.lines + chunk - 1) / chunk).arg(line).arg(chunk)
+                .arg(double(chunk) / cfg.rate, 0, 'f', 3);
+    } else {
+        cmd_str = QString("yes %1 | head -n %2").arg(line).arg(cfg.lines);
+    }
+    if (cfg.stall_every > 0 && job % cfg.stall_every == 0) {
+        cmd_str.prepend(QString("sleep %1; ").arg(cfg.stall_ms / 1000.0, 0, 'f', 3));
+    }
+    return cmd_str;
+}
+
+// same workload as commandFor() but replayed by the mock backend
+static void setupMock(Cmd *cmd, const Config &cfg)
+{
+    CmdMockBackend *backend = new CmdMockBackend;
+    CmdMockScript script = CmdMockBackend::generate(QByteArray(cfg.line_length, 'x'), cfg.lines, cfg.rate);
+    backend->setDefaultScript(script);
+    script.steps.prepend(CmdMockStep{cfg.stall_ms, QByteArray(), QByteArray()}); // like "sleep n;" before the output
+    backend->addScript("^sleep ", script);
+    cmd->setBackend(backend);
+}
+
+static void report(const Config &cfg, QVector<qint64> latencies, qint64 total_ns, qint64 bytes,
+                   int failed, int killed, int fifo_sent, int fifo_received)
+{
+    const double secs = total_ns / 1e9;
+    out << "commands: " << latencies.size() << " in " << QString::number(secs, 'f', 2) << " s, "
+        << failed << " failed, " << killed << " killed\n";
+    out << "throughput: " << QString::number(latencies.size() / secs, 'f', 1) << " cmd/s, "
+        << QString::number(bytes / secs / 1e6, 'f', 2) << " MB/s output\n";
+    if (!latencies.isEmpty()) {
+        std::sort(latencies.begin(), latencies.end());
+        auto msec = [&latencies](double p) {
+            int i = qMin(latencies.size() - 1, int(p * latencies.size()));
+            return QString::number(latencies.at(i) / 1e6, 'f', 2);
+        };
+        out << "latency ms: p50 " << msec(0.5) << "  p90 " << msec(0.9) << "  p99 " << msec(0.99)
+            << "  max " << msec(1) << "\n";
+    }
+    if (cfg.fifo_rate > 0) {
+        out << "fifo: " << fifo_sent << " sent, " << fifo_received << " change notifications\n";
+    }
+    rusage self, children;
+    getrusage(RUSAGE_SELF, &self);
+    getrusage(RUSAGE_CHILDREN, &children);
+    out << "host cpu: " << QString::number(seconds(self.ru_utime), 'f', 2) << " s user, "
+        << QString::number(seconds(self.ru_stime), 'f', 2) << " s sys ("
+        << QString::number(100 * (seconds(self.ru_utime) + seconds(self.ru_stime)) / secs, 'f', 1) << "%)\n";
+    out << "children cpu: " << QString::number(seconds(children.ru_utime), 'f', 2) << " s user, "
+        << QString::number(seconds(children.ru_stime), 'f', 2) << " s sys\n";
+    out << "host memory: " << currentRss() << " kB rss, " << self.ru_maxrss << " kB max rss\n";
+    out.flush();
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("cmdstress");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Synthetic workload generator for libcmd");
+    parser.addHelpOption();
+    QCommandLineOption commands_opt(QStringList() << "n" << "commands", "Total commands to run.", "n", "1000");
+    QCommandLineOption concurrency_opt(QStringList() << "j" << "concurrency", "Commands running at once.", "n", "8");
+    QCommandLineOption lines_opt("lines", "Output lines per command.", "n", "100");
+    QCommandLineOption length_opt("line-length", "Bytes per output line.", "n", "80");
+    QCommandLineOption rate_opt("rate", "Output lines per second per command, 0 for unlimited.", "n", "0");
+    QCommandLineOption stall_every_opt("stall-every", "Every n-th command stalls before output.", "n", "0");
+    QCommandLineOption stall_ms_opt("stall-ms", "Stall duration.", "ms", "1000");
+    QCommandLineOption kill_every_opt("kill-every", "Every n-th command is terminated.", "n", "0");
+    QCommandLineOption kill_after_opt("kill-after", "Delay before terminating.", "ms", "50");
+    QCommandLineOption fifo_opt("fifo-rate", "FIFO messages per second exchanged meanwhile.", "n", "0");
+    QCommandLineOption mock_opt("mock", "Use the mock backend, no processes are spawned.");
+    parser.addOptions(QList<QCommandLineOption>() << commands_opt << concurrency_opt << lines_opt << length_opt
+                      << rate_opt << stall_every_opt << stall_ms_opt << kill_every_opt << kill_after_opt
+                      << fifo_opt << mock_opt);
+    parser.process(app);
+
+    Config cfg;
+    cfg.commands = qMax(1, parser.value(commands_opt).toInt());
+    cfg.concurrency = qBound(1, parser.value(concurrency_opt).toInt(), cfg.commands);
+    cfg.lines = qMax(0, parser.value(lines_opt).toInt());
+    cfg.line_length = qMax(1, parser.value(length_opt).toInt());
+    cfg.rate = qMax(0, parser.value(rate_opt).toInt());
+    cfg.stall_every = qMax(0, parser.value(stall_every_opt).toInt());
+    cfg.stall_ms = qMax(0, parser.value(stall_ms_opt).toInt());
+    cfg.kill_every = qMax(0, parser.value(kill_every_opt).toInt());
+    cfg.kill_after = qMax(0, parser.value(kill_after_opt).toInt());
+    cfg.fifo_rate = qMax(0, parser.value(fifo_opt).toInt());
+    cfg.mock = parser.isSet(mock_opt);
+
+    QEventLoop loop;
+    QElapsedTimer total;
+    QVector<qint64> latencies;
+    latencies.reserve(cfg.commands);
+    qint64 bytes = 0;
+    int next_job = 0, done = 0, failed = 0, killed = 0;
+
+    std::function<void(Worker *)> launch = [&](Worker *w) {
+        if (next_job >= cfg.commands) {
+            return;
+        }
+        const int job = next_job++;
+        w->job = job;
+        w->timer.start();
+        if (cfg.kill_every > 0 && job % cfg.kill_every == 0) {
+            QTimer::singleShot(cfg.kill_after, &w->cmd, [w, job]() {
+                if (w->job == job) w->cmd.terminate();
+            });
+        }
+        w->cmd.start(commandFor(cfg, job), QStringList("quiet"));
+    };
+
+    QList<Worker *> workers;
+    for (int i = 0; i < cfg.concurrency; ++i) {
+        Worker *w = new Worker;
+        w->cmd.setDebug(0);
+        if (cfg.mock) setupMock(&w->cmd, cfg);
+        QObject::connect(&w->cmd, &Cmd::outputAvailable, [&bytes](const QString &out) { bytes += out.size(); });
+        QObject::connect(&w->cmd, &Cmd::finished, [&, w](int exit_code, QProcess::ExitStatus exit_status) {
+            latencies << w->timer.nsecsElapsed();
+            if (exit_status != QProcess::NormalExit) {
+                ++killed;
+            } else if (exit_code != 0) {
+                ++failed;
+            }
+            w->job = -1;
+            if (++done == cfg.commands) {
+                loop.quit();
+                return;
+            }
+            QTimer::singleShot(0, &w->cmd, [&launch, w]() { launch(w); });
+        });
+        workers << w;
+    }
+
+    // FIFO chatter between two extra Cmd instances while the workload runs
+    QTemporaryDir dir;
+    Cmd fifo_writer, fifo_reader;
+    QTimer fifo_timer;
+    int fifo_sent = 0, fifo_received = 0;
+    if (cfg.fifo_rate > 0 && dir.isValid()) {
+        const QString file_name = dir.path() + "/fifo";
+        fifo_writer.setDebug(0);
+        fifo_reader.setDebug(0);
+        if (fifo_writer.connectFifo(file_name) && fifo_reader.connectFifo(file_name)) {
+            QObject::connect(&fifo_reader, &Cmd::fifoChangeAvailable, [&fifo_received]() { ++fifo_received; });
+            QObject::connect(&fifo_timer, &QTimer::timeout, [&]() {
+                fifo_writer.writeToFifo(QString("msg %1").arg(fifo_sent++));
+            });
+            fifo_timer.start(qMax(1, 1000 / cfg.fifo_rate));
+        }
+    }
+
+    total.start();
+    for (Worker *w : workers) {
+        launch(w);
+    }
+    loop.exec();
+    fifo_timer.stop();
+
+    report(cfg, latencies, total.nsecsElapsed(), bytes, failed, killed, fifo_sent, fifo_received);
+    qDeleteAll(workers);
+    return 0;
+}